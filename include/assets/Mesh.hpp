@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -8,6 +10,8 @@
 #include <glm/ext.hpp>
 
 #include "assets/Vertex.hpp"
+#include "render/GlState.hpp"
+#include "render/GeometryBuffer.hpp"
 #include "utils/NonCopyable.hpp"
 
 struct AABB {
@@ -81,6 +85,7 @@ public:
 
         // store vertex count 
         count_ = static_cast<GLsizei>(vertices.size());
+        n_vertices_ = count_;
     }
 
     // Mesh with indirect vertex addressing. Needs compiled shader for attributes setup. 
@@ -97,10 +102,38 @@ public:
         count_ = static_cast<GLsizei>(indices.size());
     }
 
+    // Moves the vertices and indices into the shared buffer and draws from there, with its VAO.
+    // Only indexed meshes can move, false if the mesh stays in its own buffers.
+    bool move_to(GeometryBuffer& geometry) {
+        if (geometry_range_) {
+            return true;
+        }
+        if (ebo_ == 0) {
+            return false;
+        }
+        geometry_range_ = geometry.allocate(vbo_, n_vertices_, ebo_, count_);
+        if (!geometry_range_) {
+            return false;
+        }
+
+        glDeleteBuffers(1, &ebo_);
+        glDeleteBuffers(1, &vbo_);
+        glDeleteVertexArrays(1, &vao_);
+        GlState::vertex_array_deleted(vao_);
+        ebo_ = 0;
+        vbo_ = 0;
+        vao_ = geometry.get_vao();
+        return true;
+    }
+
     void draw() {
-        glBindVertexArray(vao_);
+        GlState::bind_vertex_array(vao_);
+        GlState::count_draw();
 
-        if (ebo_ == 0) {
+        if (geometry_range_) {
+            glDrawElementsBaseVertex(primitive_type_, count_, GL_UNSIGNED_INT, index_offset(), geometry_range_->base_vertex);
+        }
+        else if (ebo_ == 0) {
             glDrawArrays(primitive_type_, 0, count_);
         }
         else {
@@ -108,12 +141,35 @@ public:
         }
     }
 
+    // instance_count copies, gl_BaseInstance = base_instance (first one of them in the per-instance data)
+    void draw_instanced(GLsizei instance_count, GLuint base_instance) {
+        GlState::bind_vertex_array(vao_);
+        GlState::count_draw();
+
+        if (geometry_range_) {
+            glDrawElementsInstancedBaseVertexBaseInstance(primitive_type_, count_, GL_UNSIGNED_INT, index_offset(), instance_count, geometry_range_->base_vertex, base_instance);
+        }
+        else if (ebo_ == 0) {
+            glDrawArraysInstancedBaseInstance(primitive_type_, 0, count_, instance_count, base_instance);
+        }
+        else {
+            glDrawElementsInstancedBaseInstance(primitive_type_, count_, GL_UNSIGNED_INT, nullptr, instance_count, base_instance);
+        }
+    }
+
     const AABB& get_local_AABB() const { return localAABB_; }
+    GLuint get_vao() const { return vao_; }
+    GLenum get_primitive_type() const { return primitive_type_; }
+    const std::optional<GeometryRange>& get_geometry_range() const { return geometry_range_; } // set once moved to a GeometryBuffer
 
     ~Mesh() {
+        if (geometry_range_) {
+            return; // the GeometryBuffer owns the VAO and the data
+        }
         glDeleteBuffers(1, &ebo_);
         glDeleteBuffers(1, &vbo_);
         glDeleteVertexArrays(1, &vao_);
+        GlState::vertex_array_deleted(vao_);
     };
 private:
     //safe defaults
@@ -126,6 +182,13 @@ private:
     GLuint vbo_{ 0 };
     GLuint ebo_{ 0 };
 
+    GLsizei n_vertices_{ 0 };
+    std::optional<GeometryRange> geometry_range_;
+
+    const void* index_offset() const {
+        return reinterpret_cast<const void*>(static_cast<std::uintptr_t>(geometry_range_->first_index) * sizeof(GLuint));
+    }
+
     // Bounding box
     AABB localAABB_;
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <opencv2/opencv.hpp>
+#include <nlohmann/json_fwd.hpp>
+
+#include "utils/NonCopyable.hpp"
+
+// Where the tracker gets its frames from, "source" in resources/config.json
+typedef struct FrameSourceConfig {
+	std::string type = "camera"; // camera, video, images or synthetic
+	int device = 0;              // camera index
+	std::string path;            // video file or image directory
+	int width = 640;             // synthetic frame size
+	int height = 480;
+	double fps = 30.0;           // replay rate of images and synthetic frames, video files use their own
+	bool loop = true;            // start over at the end of a video or image directory
+	bool max_speed = false;      // no real-time pacing, frames as fast as they are read (benchmarks)
+} FrameSourceConfig;
+
+// Camera, recorded video, image sequence or generated frames behind one interface, so the tracker can run without a webcam
+class FrameSource : NonCopyable {
+public:
+	virtual ~FrameSource() = default;
+
+	// nullptr (with a message) if the source cannot be opened
+	static std::unique_ptr<FrameSource> create(const FrameSourceConfig& config);
+	static FrameSourceConfig config_from_json(const nlohmann::json& j);
+	static FrameSourceConfig read_config(const std::string& filename); // the "source" section, defaults if there is none
+
+	// Next BGR frame, reusing the buffer when it can. False at the end or on error. Sleeps to keep the replay rate unless max_speed.
+	bool read(cv::Mat& frame);
+
+	virtual cv::Size size() const = 0;
+	virtual std::string describe() const = 0;
+	std::uint64_t frames_read() const { return n_frames_read; }
+
+protected:
+	FrameSource() = default;
+	void set_pace(double fps); // frames per second, 0 = no pacing
+	virtual bool grab(cv::Mat& frame) = 0;
+
+private:
+	std::chrono::steady_clock::duration frame_interval{};
+	std::chrono::steady_clock::time_point next_frame_time{};
+	std::uint64_t n_frames_read = 0;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "capture/FrameSource.hpp"
+
+// All images of a directory in file name order. Decoded up front, so replay speed does not depend on the decoder.
+class ImageDirectorySource : public FrameSource {
+public:
+	static std::unique_ptr<ImageDirectorySource> open(const std::filesystem::path& directory, double fps, bool loop, bool max_speed);
+
+	cv::Size size() const override;
+	std::string describe() const override;
+
+protected:
+	bool grab(cv::Mat& frame) override;
+
+private:
+	ImageDirectorySource(std::filesystem::path directory, bool loop);
+
+	std::filesystem::path directory;
+	std::vector<cv::Mat> images; // all the size of the first one
+	std::size_t next_image = 0;
+	bool loop;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+
+#include "capture/FrameSource.hpp"
+
+// Generated frames: a red disc circling over a textured background, the same sequence on every run
+class SyntheticSource : public FrameSource {
+public:
+	SyntheticSource(cv::Size size, double fps, bool max_speed);
+
+	cv::Size size() const override;
+	std::string describe() const override;
+
+protected:
+	bool grab(cv::Mat& frame) override;
+
+private:
+	cv::Size frame_size;
+	cv::Mat background;
+	std::uint64_t n_generated = 0;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "capture/FrameSource.hpp"
+
+// A camera (paced by the device) or a video file (paced by its frame rate, can loop)
+class VideoCaptureSource : public FrameSource {
+public:
+	static std::unique_ptr<VideoCaptureSource> open_camera(int device);
+	static std::unique_ptr<VideoCaptureSource> open_file(const std::string& path, bool loop, bool max_speed);
+
+	cv::Size size() const override;
+	std::string describe() const override;
+
+protected:
+	bool grab(cv::Mat& frame) override;
+
+private:
+	VideoCaptureSource(std::string name, bool loop);
+
+	cv::VideoCapture capture_device;
+	std::string name;
+	bool loop;
+};
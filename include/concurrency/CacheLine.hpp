@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Size used to pad data written by different threads onto separate cache lines (avoids false sharing).
+// std::hardware_destructive_interference_size is not used, because its value may differ between compilers.
+inline constexpr std::size_t cache_line_size = 64;
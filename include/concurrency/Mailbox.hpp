@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "concurrency/CacheLine.hpp"
+
+// Triple-buffered latest-value channel for one producer and one consumer.
+// The producer never blocks and always overwrites, the consumer always gets the newest value.
+// A value that was overwritten before being read is handed back to the producer (e.g. to return it to a pool).
+template<typename T>
+class Mailbox {
+	static constexpr std::uint32_t index_mask = 0x3;
+	static constexpr std::uint32_t fresh_bit = 0x4; // middle slot holds a value the consumer has not taken yet
+
+protected:
+	std::array<std::optional<T>, 3> slots;
+
+	// Shared: index of the middle slot + fresh bit
+	alignas(cache_line_size) std::atomic<std::uint32_t> middle{1};
+	std::atomic<std::size_t> n_dropped{0};
+
+	// Producer owned
+	alignas(cache_line_size) std::uint32_t back = 0;
+
+	// Consumer owned
+	alignas(cache_line_size) std::uint32_t front = 2;
+
+public:
+	Mailbox() = default;
+	Mailbox(const Mailbox<T>&) = delete;
+
+	// Producer only. Publishes the item and returns the unread value it displaced, if there was one.
+	std::optional<T> push_back(T&& item) {
+		slots[back].emplace(std::move(item));
+		const std::uint32_t previous = middle.exchange(back | fresh_bit, std::memory_order_acq_rel);
+		middle.notify_one();
+
+		back = previous & index_mask;
+		std::optional<T> displaced;
+		if (previous & fresh_bit) {
+			displaced = std::move(slots[back]);
+			n_dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+		slots[back].reset();
+		return displaced;
+	}
+
+	// Consumer only. Returns the newest value, if it was not taken already.
+	std::optional<T> try_pop_front() {
+		if (!(middle.load(std::memory_order_relaxed) & fresh_bit))
+			return std::nullopt;
+
+		// Hand our empty slot over, take the fresh one (the producer may only have made it fresher meanwhile)
+		const std::uint32_t previous = middle.exchange(front, std::memory_order_acq_rel);
+		front = previous & index_mask;
+
+		std::optional<T> item{ std::move(slots[front]) };
+		slots[front].reset();
+		return item;
+	}
+
+	// Consumer only. Blocks until a new value is published.
+	void wait() {
+		std::uint32_t m = middle.load(std::memory_order_acquire);
+		while (!(m & fresh_bit)) {
+			middle.wait(m, std::memory_order_acquire);
+			m = middle.load(std::memory_order_acquire);
+		}
+	}
+
+	bool empty() const {
+		return !(middle.load(std::memory_order_acquire) & fresh_bit);
+	}
+
+	// Number of values overwritten before the consumer saw them
+	std::size_t dropped() const {
+		return n_dropped.load(std::memory_order_relaxed);
+	}
+};
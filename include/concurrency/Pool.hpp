@@ -1,13 +1,83 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <tuple>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <stop_token>
 
 #include "utils/NonCopyable.hpp"
+#include "concurrency/CacheLine.hpp"
 #include "concurrency/SyncedDeque.hpp"
+#include "concurrency/WaitSignal.hpp"
 
 #define POOL_N_PREALLOCATE 3
 #define POOL_N_MAX 5
+#define POOL_N_CACHE_SLOTS 16 // per-thread caches, threads beyond this share slots
+
+template<typename T>
+class Pool;
+
+// An object borrowed from a Pool, goes back to it automatically when the lease ends.
+// A lease without a pool simply owns (and deletes) its object.
+template<typename T>
+class Lease {
+    private:
+        Pool<T>* pool = nullptr;
+        std::unique_ptr<T> element;
+    public:
+        Lease() = default;
+        Lease(Pool<T>* pool, std::unique_ptr<T>&& element) : pool{ pool }, element{ std::move(element) } {}
+        explicit Lease(std::unique_ptr<T>&& element) : element{ std::move(element) } {}
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        Lease(Lease&& other) noexcept : pool{ other.pool }, element{ std::move(other.element) } {
+            other.pool = nullptr;
+        }
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                pool = other.pool;
+                element = std::move(other.element);
+                other.pool = nullptr;
+            }
+            return *this;
+        }
+
+        ~Lease() {
+            reset();
+        }
+
+        // Return the object now
+        void reset() {
+            if (element && pool) {
+                pool->release(std::move(element));
+            }
+            element.reset();
+            pool = nullptr;
+        }
+
+        T* get() const { return element.get(); }
+        T* operator->() const { return element.get(); }
+        T& operator*() const { return *element; }
+        explicit operator bool() const { return element != nullptr; }
+};
+
+// Pool counters, for finding the real steady-state size
+typedef struct PoolStats {
+    std::size_t cache_hits;    // acquired from a per-thread cache
+    std::size_t shared_hits;   // acquired from the shared free list
+    std::size_t misses;        // had to construct a new object
+    std::size_t blocked_waits; // had to wait for a release
+    std::size_t allocated;     // objects constructed so far
+    std::size_t in_use;        // objects leased right now
+    std::size_t high_water;    // most objects leased at the same time
+} PoolStats;
 
 template<typename T>
 class Pool : NonCopyable {
@@ -19,13 +89,113 @@ class Pool : NonCopyable {
         typedef std::function<T_ptr ()> Factory;
         std::unique_ptr<Factory> factory;
 
+        // Per-thread caches: one free object per slot, taken and put back without a lock.
+        // A waiting thread may also empty the slots of others, so cached objects are never stranded.
+        struct alignas(cache_line_size) CacheSlot {
+            std::atomic<T*> element{ nullptr };
+        };
+        std::array<CacheSlot, POOL_N_CACHE_SLOTS> cache;
+        WaitSignal released; // notified on every release
+
+        // Stats
+        std::atomic<std::size_t> nCacheHits{0};
+        std::atomic<std::size_t> nSharedHits{0};
+        std::atomic<std::size_t> nMisses{0};
+        std::atomic<std::size_t> nBlockedWaits{0};
+        std::atomic<std::size_t> nInUse{0};
+        std::atomic<std::size_t> nHighWater{0};
+
+        static std::size_t thread_slot() {
+            static std::atomic<std::size_t> next_slot{0};
+            thread_local const std::size_t slot = next_slot.fetch_add(1) % POOL_N_CACHE_SLOTS;
+            return slot;
+        }
+
         void preallocate(const std::size_t n) {
             for (std::size_t i = 0; i < n; i++) {
                 freeElements.push_back((*factory)());
             }
             nAllocated += n;
         }
+
+        bool try_allocate() {
+            // Reserve one more element, if the limit allows it
+            std::size_t n = nAllocated.load();
+            while (n < nMax) {
+                if (nAllocated.compare_exchange_weak(n, n + 1)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        T_ptr take_own_cached() {
+            return T_ptr(cache[thread_slot()].element.exchange(nullptr, std::memory_order_acquire));
+        }
+
+        T_ptr take_any_cached() {
+            for (auto& slot : cache) {
+                if (slot.element.load(std::memory_order_relaxed)) {
+                    if (T* element = slot.element.exchange(nullptr, std::memory_order_acquire)) {
+                        return T_ptr(element);
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        // Everything that does not need to wait, cheapest first
+        T_ptr try_take() {
+            if (auto element = take_own_cached()) {
+                nCacheHits++;
+                return element;
+            }
+            if (auto element = freeElements.try_pop_front()) {
+                nSharedHits++;
+                return std::move(*element);
+            }
+            if (auto element = take_any_cached()) {
+                nCacheHits++;
+                return element;
+            }
+            if (try_allocate()) {
+                nMisses++;
+                return (*factory)();
+            }
+            return nullptr;
+        }
+
+        // Released objects may land in the shared list or in any cache slot
+        T_ptr try_take_released() {
+            if (auto element = freeElements.try_pop_front()) {
+                nSharedHits++;
+                return std::move(*element);
+            }
+            if (auto element = take_any_cached()) {
+                nCacheHits++;
+                return element;
+            }
+            return nullptr;
+        }
+
+        Lease<T> lease(T_ptr&& element) {
+            if (!element) {
+                return Lease<T>{};
+            }
+            auto in_use = ++nInUse;
+            auto high_water = nHighWater.load();
+            while (in_use > high_water && !nHighWater.compare_exchange_weak(high_water, in_use)) {}
+            return Lease<T>{ this, std::move(element) };
+        }
     public:
+        Pool() = default;
+
+        ~Pool() {
+            for (auto& slot : cache) {
+                delete slot.element.exchange(nullptr);
+            }
+        }
+
         template <typename... Args>
             requires std::constructible_from<T, Args...>
         void init(const std::tuple<Args...>& args, const std::size_t nPreallocate = POOL_N_PREALLOCATE, const std::size_t nMax = POOL_N_MAX) {
@@ -49,23 +219,58 @@ class Pool : NonCopyable {
             init(std::tuple(args...));
         }
 
-        T_ptr acquire() {
-            // Acquire a free object for use
-            if (!freeElements.empty()) {
-                return freeElements.pop_front();
+        // Blocks while all objects are in use. Returns an empty lease if the stop is requested meanwhile.
+        Lease<T> acquire(std::stop_token stop = {}) {
+            if (auto element = try_take()) {
+                return lease(std::move(element));
             }
 
-            if (nAllocated < nMax) {
-                nAllocated++;
-                return (*factory)();
+            nBlockedWaits++;
+            T_ptr element;
+            released.wait([this, &element]() { element = try_take_released(); return element != nullptr; }, stop);
+            return lease(std::move(element));
+        }
+
+        // Like acquire(), but gives up (returns an empty lease) after the timeout
+        template<typename Rep, typename Period>
+        Lease<T> try_acquire_for(const std::chrono::duration<Rep, Period>& timeout, std::stop_token stop = {}) {
+            if (auto element = try_take()) {
+                return lease(std::move(element));
             }
 
-            freeElements.wait();
-            return freeElements.pop_front();
+            nBlockedWaits++;
+            T_ptr element;
+            released.wait_for([this, &element]() { element = try_take_released(); return element != nullptr; }, timeout, stop);
+            return lease(std::move(element));
         }
 
+        // Called by Lease. Release a used object back to the pool, into this thread's cache if it is free.
         void release(T_ptr&& element) {
-            // Release a used object back to the pool
-            freeElements.push_back(std::move(element));
+            if (!element) {
+                return;
+            }
+            nInUse--;
+
+            T* expected = nullptr;
+            T* raw = element.get();
+            if (cache[thread_slot()].element.compare_exchange_strong(expected, raw, std::memory_order_release)) {
+                element.release();
+            }
+            else {
+                freeElements.push_back(std::move(element));
+            }
+            released.notify_one();
+        }
+
+        PoolStats stats() const {
+            return PoolStats{
+                nCacheHits.load(),
+                nSharedHits.load(),
+                nMisses.load(),
+                nBlockedWaits.load(),
+                nAllocated.load(),
+                nInUse.load(),
+                nHighWater.load()
+            };
         }
-};
\ No newline at end of file
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "concurrency/CacheLine.hpp"
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Mirrors the push_back/try_pop_front/wait surface of SyncedDeque, but never takes a lock.
+template<typename T, std::size_t Capacity>
+class SpscRing {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+	static constexpr std::uint32_t mask = Capacity - 1;
+
+protected:
+	std::array<std::optional<T>, Capacity> slots;
+
+	// Consumer owned line: read position and the last seen write position
+	alignas(cache_line_size) std::atomic<std::uint32_t> head{0};
+	std::uint32_t cached_tail = 0;
+
+	// Producer owned line: write position and the last seen read position
+	alignas(cache_line_size) std::atomic<std::uint32_t> tail{0};
+	std::uint32_t cached_head = 0;
+
+	// Keep whatever follows the ring off the producer line
+	alignas(cache_line_size) std::byte end_padding{};
+
+public:
+	SpscRing() = default;
+	SpscRing(const SpscRing<T, Capacity>&) = delete;
+
+	// Producer only. Returns false (and leaves the item untouched) when the ring is full.
+	[[nodiscard]] bool push_back(T&& item) {
+		const std::uint32_t t = tail.load(std::memory_order_relaxed);
+		if (t - cached_head == Capacity) {
+			cached_head = head.load(std::memory_order_acquire);
+			if (t - cached_head == Capacity)
+				return false;
+		}
+
+		slots[t & mask].emplace(std::move(item));
+		tail.store(t + 1, std::memory_order_release);
+		tail.notify_one(); // cheap when nobody is waiting
+		return true;
+	}
+
+	// Consumer only
+	std::optional<T> try_pop_front() {
+		const std::uint32_t h = head.load(std::memory_order_relaxed);
+		if (h == cached_tail) {
+			cached_tail = tail.load(std::memory_order_acquire);
+			if (h == cached_tail)
+				return std::nullopt;
+		}
+
+		auto& slot = slots[h & mask];
+		std::optional<T> item{ std::move(*slot) };
+		slot.reset();
+		head.store(h + 1, std::memory_order_release);
+		return item;
+	}
+
+	// Consumer only. Blocks until there is something to pop.
+	void wait() {
+		const std::uint32_t h = head.load(std::memory_order_relaxed);
+		std::uint32_t t = tail.load(std::memory_order_acquire);
+		while (t == h) {
+			tail.wait(t, std::memory_order_acquire);
+			t = tail.load(std::memory_order_acquire);
+		}
+	}
+
+	// Approximate when called from the other side, exact from the owning threads
+	bool empty() const {
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+	std::size_t count() const {
+		const std::uint32_t h = head.load(std::memory_order_acquire); // head first, so tail can not fall behind it
+		return tail.load(std::memory_order_acquire) - h;
+	}
+
+	static constexpr std::size_t capacity() {
+		return Capacity;
+	}
+};
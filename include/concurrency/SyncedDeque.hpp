@@ -2,16 +2,18 @@
 
 #include <deque>
 #include <mutex>
-#include <condition_variable>
 #include <optional>
+#include <chrono>
+#include <stop_token>
+
+#include "concurrency/WaitSignal.hpp"
 
 template<typename T>
 class SyncedDeque {
 protected:
 	std::mutex mux;
 	std::deque<T> de_queue;
-	std::condition_variable cv_sleep;
-	std::mutex mux_sleep;
+	WaitSignal signal; // notified after every push
 
 public:
 	SyncedDeque() = default;
@@ -56,19 +58,19 @@ public:
 	}
 
 	void push_back(T&& item) {
-		std::scoped_lock lock(mux);
-		de_queue.emplace_back(std::move(item));
-
-		std::unique_lock<std::mutex> ul(mux_sleep);
-		cv_sleep.notify_one();
+		{
+			std::scoped_lock lock(mux);
+			de_queue.emplace_back(std::move(item));
+		}
+		signal.notify_one();
 	}
 
 	void push_front(T&& item) {
-		std::scoped_lock lock(mux);
-		de_queue.emplace_front(std::move(item));
-
-		std::unique_lock<std::mutex> ul(mux_sleep);
-		cv_sleep.notify_one();
+		{
+			std::scoped_lock lock(mux);
+			de_queue.emplace_front(std::move(item));
+		}
+		signal.notify_one();
 	}
 	bool empty() {
 		std::scoped_lock lock(mux);
@@ -86,10 +88,36 @@ public:
 	}
 
 	void wait() {
-		while (empty()) {
-			std::unique_lock<std::mutex> ul(mux_sleep);
-			cv_sleep.wait(ul);
-		}
+		signal.wait([this]() { return !empty(); });
+	}
+
+	// Returns false if the stop was requested before anything arrived
+	bool wait(std::stop_token stop) {
+		return signal.wait([this]() { return !empty(); }, stop);
+	}
+
+	template<typename Rep, typename Period>
+	bool wait_for(const std::chrono::duration<Rep, Period>& timeout, std::stop_token stop = {}) {
+		return signal.wait_for([this]() { return !empty(); }, timeout, stop);
+	}
+
+	// Wait and pop as one step, so concurrent consumers can not take the item between the two
+	std::optional<T> wait_pop_front(std::stop_token stop = {}) {
+		std::optional<T> item;
+		signal.wait([this, &item]() { item = try_pop_front(); return item.has_value(); }, stop);
+		return item;
+	}
+
+	template<typename Rep, typename Period>
+	std::optional<T> wait_pop_front_for(const std::chrono::duration<Rep, Period>& timeout, std::stop_token stop = {}) {
+		std::optional<T> item;
+		signal.wait_for([this, &item]() { item = try_pop_front(); return item.has_value(); }, timeout, stop);
+		return item;
+	}
+
+	// Wake up all waiters, e.g. so they can re-check a shutdown flag
+	void notify_all() {
+		signal.notify_all();
 	}
 
 };
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "utils/NonCopyable.hpp"
+#include "concurrency/CacheLine.hpp"
+#include "concurrency/WaitSignal.hpp"
+#include "utils/Profiler.hpp"
+
+#define TASK_QUEUE_CAPACITY 256
+
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops its own work at the bottom (LIFO, cache friendly),
+// idle workers steal from the top of the others (FIFO, oldest = usually the biggest piece of work).
+// Threads outside the pool spread their submissions over the worker deques.
+class TaskScheduler : NonCopyable {
+protected:
+	typedef struct Task {
+		void (*run)(void* context);
+		void* context;
+	} Task;
+
+	// Fixed-size, so pushing work never allocates. A full queue makes the submitter run the task itself.
+	struct alignas(cache_line_size) WorkQueue {
+		std::mutex mux;
+		std::array<Task, TASK_QUEUE_CAPACITY> ring{};
+		std::size_t top = 0;    // steal end
+		std::size_t bottom = 0; // owner end
+
+		bool push_bottom(const Task& task) {
+			std::scoped_lock lock(mux);
+			if (bottom - top == ring.size())
+				return false;
+			ring[bottom++ % ring.size()] = task;
+			return true;
+		}
+
+		bool pop_bottom(Task& task) {
+			std::scoped_lock lock(mux);
+			if (bottom == top)
+				return false;
+			task = ring[--bottom % ring.size()];
+			return true;
+		}
+
+		bool steal_top(Task& task, bool wait_for_lock = false) {
+			std::unique_lock lock(mux, std::defer_lock);
+			if (wait_for_lock)
+				lock.lock();
+			else if (!lock.try_lock()) // a busy queue is usually not worth waiting for
+				return false;
+			if (bottom == top)
+				return false;
+			task = ring[top++ % ring.size()];
+			return true;
+		}
+	};
+
+	std::vector<std::unique_ptr<WorkQueue>> queues; // one per worker
+	std::vector<std::jthread> workers;
+	std::atomic<std::ptrdiff_t> n_queued{0}; // counted after the push, so a fast thief can take it below zero for a moment
+	std::atomic<std::size_t> next_queue{0};
+	WaitSignal signal;   // work was queued: wakes idle workers
+	WaitSignal progress; // a task finished or was queued: wakes threads waiting in help_until()
+
+	inline static thread_local TaskScheduler* current_scheduler = nullptr;
+	inline static thread_local std::size_t current_worker = 0;
+
+	void push(const Task& task) {
+		std::size_t index = (current_scheduler == this) ? current_worker : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+		if (!queues[index]->push_bottom(task)) {
+			run(task); // saturated, do it now
+			return;
+		}
+		n_queued.fetch_add(1, std::memory_order_relaxed);
+		signal.notify_one();
+		progress.notify_all();
+	}
+
+	void run(const Task& task) {
+		task.run(task.context);
+		progress.notify_all(); // only reaches the kernel when someone waits
+	}
+
+	bool find_task(std::size_t first, Task& task, bool wait_for_locks = false) {
+		// own queue first (when called by a worker), then steal round the others
+		if (current_scheduler == this && queues[current_worker]->pop_bottom(task)) {
+			n_queued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		for (std::size_t i = 0; i < queues.size(); i++) {
+			if (queues[(first + i) % queues.size()]->steal_top(task, wait_for_locks)) {
+				n_queued.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void worker_loop(std::stop_token stop, std::size_t index) {
+		current_scheduler = this;
+		current_worker = index;
+		PROFILE_THREAD("scheduler worker");
+
+		while (!stop.stop_requested()) {
+			Task task;
+			if (find_task(index + 1, task)) {
+				run(task);
+				continue;
+			}
+			if (n_queued.load(std::memory_order_relaxed) > 0) {
+				// work is queued, but every steal lost the race for a lock: take the locks rather than spin
+				if (find_task(index + 1, task, true)) {
+					run(task);
+				}
+				else {
+					std::this_thread::yield(); // the task was just taken, its count is about to drop
+				}
+				continue;
+			}
+			signal.wait([this]() { return n_queued.load(std::memory_order_relaxed) > 0; }, stop);
+		}
+	}
+
+public:
+	explicit TaskScheduler(std::size_t n_workers = default_worker_count()) {
+		n_workers = std::max<std::size_t>(n_workers, 1);
+		for (std::size_t i = 0; i < n_workers; i++) {
+			queues.push_back(std::make_unique<WorkQueue>());
+		}
+		for (std::size_t i = 0; i < n_workers; i++) {
+			workers.emplace_back([this, i](std::stop_token stop) { worker_loop(stop, i); });
+		}
+	}
+
+	~TaskScheduler() {
+		for (auto& worker : workers) {
+			worker.request_stop();
+		}
+		signal.notify_all();
+		workers.clear(); // joins
+
+		// Finish what is left, so no future is left without a value
+		Task task;
+		while (find_task(0, task, true)) {
+			task.run(task.context);
+		}
+	}
+
+	// The calling thread helps while it waits, so one worker less than cores
+	static std::size_t default_worker_count() {
+		auto n_cores = static_cast<std::size_t>(std::thread::hardware_concurrency());
+		return n_cores > 1 ? n_cores - 1 : 1;
+	}
+
+	// Shared instance for the whole app (recognizers, asset loading)
+	static TaskScheduler& global() {
+		static TaskScheduler scheduler;
+		return scheduler;
+	}
+
+	std::size_t worker_count() const {
+		return workers.size();
+	}
+
+	// Run one queued task on the calling thread. Returns false if there was nothing to do.
+	bool run_pending_task() {
+		Task task;
+		if (!find_task(next_queue.load(std::memory_order_relaxed), task))
+			return false;
+		run(task);
+		return true;
+	}
+
+	// Run queued tasks until done() returns true, sleeping while there is nothing to run
+	// (so a join never spins a core, and never blocks a worker that others depend on).
+	// done() is rechecked whenever a task finishes or is queued.
+	template<typename Predicate>
+	void help_until(Predicate done) {
+		while (!done()) {
+			Task task;
+			if (find_task(next_queue.load(std::memory_order_relaxed), task, true)) {
+				run(task);
+				continue;
+			}
+			progress.wait([&]() { return done() || n_queued.load(std::memory_order_relaxed) > 0; });
+		}
+	}
+
+	// Fire and forget, without allocating. The context must stay valid until run() has returned.
+	void submit_detached(void (*run)(void* context), void* context) {
+		push(Task{ run, context });
+	}
+
+	template<typename F>
+	auto submit(F&& function) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+		using Result = std::invoke_result_t<std::decay_t<F>>;
+		auto task = new std::packaged_task<Result()>(std::forward<F>(function));
+		auto future = task->get_future();
+		push(Task{
+			[](void* context) {
+				auto task = static_cast<std::packaged_task<Result()>*>(context);
+				(*task)();
+				delete task;
+			},
+			task
+		});
+		return future;
+	}
+
+	// Wait for a submitted task, running other tasks meanwhile (never blocks a worker that others depend on)
+	template<typename R>
+	R wait(std::future<R>& future) {
+		help_until([&future]() { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+		return future.get();
+	}
+
+	// Calls body(chunk_begin, chunk_end) over [begin, end) split into chunks of grain elements, returns when all are done.
+	// Does not allocate: the loop state lives on the caller's stack. The body must not throw.
+	template<typename F>
+	void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const F& body) {
+		if (end <= begin)
+			return;
+		grain = std::max<std::size_t>(grain, 1);
+
+		struct Loop {
+			const F* body;
+			std::size_t begin, end, grain, n_chunks;
+			std::atomic<std::size_t> next_chunk{0};
+			std::atomic<std::size_t> helpers_left{0};
+
+			void run_chunks() {
+				std::size_t chunk;
+				while ((chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < n_chunks) {
+					std::size_t chunk_begin = begin + chunk * grain;
+					(*body)(chunk_begin, std::min(end, chunk_begin + grain));
+				}
+			}
+		};
+
+		Loop loop{ &body, begin, end, grain, (end - begin + grain - 1) / grain };
+		const std::size_t n_helpers = std::min(workers.size(), loop.n_chunks - 1);
+		loop.helpers_left.store(n_helpers, std::memory_order_relaxed);
+		for (std::size_t i = 0; i < n_helpers; i++) {
+			push(Task{
+				[](void* context) {
+					auto loop = static_cast<Loop*>(context);
+					loop->run_chunks();
+					loop->helpers_left.fetch_sub(1, std::memory_order_release);
+				},
+				&loop
+			});
+		}
+
+		loop.run_chunks();
+
+		// Helpers reference the loop on this stack, wait until every one of them is out
+		help_until([&loop]() { return loop.helpers_left.load(std::memory_order_acquire) == 0; });
+	}
+};
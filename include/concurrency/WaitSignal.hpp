@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+
+#include "concurrency/CacheLine.hpp"
+
+// Blocking primitive built on C++20 std::atomic::wait/notify (a futex on Linux).
+// Waiters check a predicate over state guarded elsewhere; notifiers change that state first and then notify.
+// Every notification bumps an epoch counter, and a waiter only sleeps while the epoch it read before checking
+// the predicate is still current, so a notification between the check and the sleep can not be lost.
+class WaitSignal {
+protected:
+	alignas(cache_line_size) std::atomic<std::uint32_t> epoch{0};
+
+public:
+	WaitSignal() = default;
+	WaitSignal(const WaitSignal&) = delete;
+
+	void notify_one() {
+		epoch.fetch_add(1, std::memory_order_release);
+		epoch.notify_one();
+	}
+
+	void notify_all() {
+		epoch.fetch_add(1, std::memory_order_release);
+		epoch.notify_all();
+	}
+
+	// Block until ready() returns true
+	template<typename Predicate>
+	void wait(Predicate ready) {
+		while (true) {
+			const std::uint32_t seen = epoch.load(std::memory_order_acquire);
+			if (ready())
+				return;
+			epoch.wait(seen, std::memory_order_acquire);
+		}
+	}
+
+	// Block until ready() returns true (returns true) or a stop is requested (returns false)
+	template<typename Predicate>
+	bool wait(Predicate ready, std::stop_token stop) {
+		std::stop_callback on_stop(stop, [this]() { notify_all(); });
+		while (true) {
+			const std::uint32_t seen = epoch.load(std::memory_order_acquire);
+			if (ready())
+				return true;
+			if (stop.stop_requested())
+				return false;
+			epoch.wait(seen, std::memory_order_acquire);
+		}
+	}
+
+	// Like wait(ready, stop), but gives up (returns false) after the timeout.
+	// std::atomic::wait has no timed variant, so this polls the epoch with an exponential back-off capped at 1 ms.
+	template<typename Predicate, typename Rep, typename Period>
+	bool wait_for(Predicate ready, const std::chrono::duration<Rep, Period>& timeout, std::stop_token stop = {}) {
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+		std::chrono::microseconds backoff{ 20 };
+		std::uint32_t seen = epoch.load(std::memory_order_acquire);
+		while (true) {
+			if (ready())
+				return true;
+			if (stop.stop_requested())
+				return false;
+
+			const auto now = std::chrono::steady_clock::now();
+			if (now >= deadline)
+				return false;
+
+			// Sleep only while nothing was notified since the last check
+			while (epoch.load(std::memory_order_acquire) == seen && std::chrono::steady_clock::now() < deadline && !stop.stop_requested()) {
+				std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(backoff, deadline - std::chrono::steady_clock::now()));
+				backoff = std::min(backoff * 2, std::chrono::microseconds{ 1000 });
+			}
+			seen = epoch.load(std::memory_order_acquire);
+		}
+	}
+};
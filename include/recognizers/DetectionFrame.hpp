@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+
+#include <opencv2/opencv.hpp>
+
+#include "utils/NonCopyable.hpp"
+
+#define DETECTION_MAX_LEVELS 4 // full resolution, 1/2, 1/4, 1/8
+
+// One camera frame prepared for the recognizers: a pyramid of halved images, each with gray and HSV versions.
+// Everything is built on first use and only once, several recognizers may read the same frame at the same time.
+// Keep one per detector and reset() it for every frame: the buffers are reused, so the steady state does not allocate.
+class DetectionFrame : NonCopyable {
+public:
+	DetectionFrame() = default;
+	explicit DetectionFrame(const cv::Mat& image); // BGR, the pixels are shared and must stay unchanged meanwhile
+
+	// Start over with a new frame, nobody may be reading the old one
+	void reset(const cv::Mat& image);
+
+	// Smallest level that is still at least scale * full resolution (scale 1 = full, 0.5 = half, ...)
+	static int level_for(float scale);
+
+	const cv::Mat& bgr(int level);
+	const cv::Mat& gray(int level);
+	const cv::Mat& hsv(int level);
+
+private:
+	typedef struct Level {
+		cv::Mat bgr, gray, hsv;
+		bool has_bgr = false, has_gray = false, has_hsv = false;
+		std::mutex bgr_mux, gray_mux, hsv_mux;
+	} Level;
+	std::array<Level, DETECTION_MAX_LEVELS> levels;
+
+	static void downscale(const cv::Mat& src, cv::Mat& dst);
+};
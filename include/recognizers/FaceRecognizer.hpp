@@ -1,9 +1,27 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
+#include <future>
 
 #include <opencv2/opencv.hpp>
 
+#include "recognizers/DetectionFrame.hpp"
+#include "utils/FixedVector.hpp"
+
+#define FACE_ROI_PADDING 0.5f         // search area around a tracked face, as a fraction of its size per side
+#define FACE_ROI_SCALE_STEP 1.3f      // tracked search only looks for faces this much smaller / bigger than the last one
+#define FACE_FULL_SCAN_INTERVAL 15    // default frames between forced full-frame scans (new faces entering the view)
+#define FACE_MAX_FACES 8              // more faces in one frame are counted in dropped_faces(), not reported
+
+typedef FixedVector<cv::Point2f, FACE_MAX_FACES> FaceCenters; // normalized face centers
+
+// Scratch buffers of one find_face caller, reused from frame to frame
+typedef struct FaceWorkspace {
+	std::vector<cv::Rect> faces; // this frame's detections, in pixels of the working level
+	std::vector<cv::Rect> found; // one detectMultiScale call
+} FaceWorkspace;
+
 class FaceRecognizer {
 public:
 	FaceRecognizer();
@@ -11,9 +29,31 @@ public:
 	int run(void);
 	~FaceRecognizer();
 	std::vector<cv::Point2f> find_face(cv::Mat& frame);
+	std::future<std::vector<cv::Point2f>> find_face_async(const cv::Mat& frame); // runs on the shared task scheduler
+	// Our buffers are reused (once the workspace has grown), but detectMultiScale still allocates inside OpenCV every frame
+	void find_face(DetectionFrame& frame, FaceWorkspace& workspace, FaceCenters& centers);
 
+	// Fraction of the camera resolution to detect at, rounded up to a pyramid level (1, 1/2, 1/4, 1/8)
+	void set_working_scale(float scale);
+
+	// Tracking: search only around the last detections, full scan every full_scan_interval frames or when a face is lost
+	void set_tracking(bool enabled, int full_scan_interval = FACE_FULL_SCAN_INTERVAL);
+
+	// Faces detected beyond FACE_MAX_FACES and left out of the centers, in total (readable from any thread)
+	std::size_t dropped_faces() const { return n_dropped_faces.load(std::memory_order_relaxed); }
 
 private:
 	cv::CascadeClassifier classifier;
 	cv::VideoCapture capture_device;
+
+	int working_level = 0;
+	bool tracking_on = true;
+	int full_scan_interval = FACE_FULL_SCAN_INTERVAL;
+	int frames_since_full_scan = 0;
+	bool last_full_scan = true;
+	std::vector<cv::Rect> tracked_faces; // last detections, in pixels of the working level
+	std::atomic<std::size_t> n_dropped_faces{ 0 };
+
+	void scan_full(const cv::Mat& scene_grey, FaceWorkspace& workspace);
+	bool scan_tracked(const cv::Mat& scene_grey, FaceWorkspace& workspace);
 };
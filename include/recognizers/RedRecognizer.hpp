@@ -4,13 +4,26 @@
 
 #include <opencv2/opencv.hpp>
 
+#include "recognizers/DetectionFrame.hpp"
+
+#define RED_STRIPE_ROWS 64 // rows per parallel task
+#define RED_MIN_SATURATION 150
+#define RED_MIN_VALUE 150
+#define RED_MAX_HUE 20 // hue distance from pure red, on OpenCV's 0-180 hue scale
+
 class RedRecognizer {
 public:
 	RedRecognizer();
 	int run_static(std::string path);
 	int run_video(std::string path);
 	cv::Point2f find_red(cv::Mat& frame);
+	cv::Point2f find_red(DetectionFrame& frame); // fused single-pass SIMD kernel, no per-frame allocations
+	static cv::Point2f find_red_reference(const cv::Mat& frame); // cvtColor + inRange + findNonZero, for checking the kernel
+
+	// Fraction of the camera resolution to detect at, rounded up to a pyramid level (1, 1/2, 1/4, 1/8)
+	void set_working_scale(float scale);
 
 private:
+	int working_level = 0;
 	cv::VideoCapture capture_device;
 };
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "utils/NonCopyable.hpp"
+
+#define CAMERA_UNIFORMS_BINDING 0 // uniform block "Camera" of the scene shaders
+
+// Per-frame camera data as the shaders read it (std140)
+typedef struct CameraData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 position; // w unused
+} CameraData;
+
+// The uniform buffer behind the "Camera" block: written and bound once per frame, before the scene draws.
+// Every program sees it, so no draw sets the view or projection matrix itself.
+class CameraUniforms : private NonCopyable {
+public:
+    CameraUniforms();
+    ~CameraUniforms();
+
+    void update(const glm::mat4& view_matrix, const glm::mat4& projection_matrix, const glm::vec3& camera_position); // also binds
+    void bind() const;
+private:
+    GLuint buffer = 0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "assets/Mesh.hpp"
+#include "render/ShaderProgram.hpp"
+#include "utils/NonCopyable.hpp"
+
+#define CULL_INPUT_BINDING    5 // all instances; the visible ones go to INSTANCE_DATA_BINDING
+#define CULL_COMMANDS_BINDING 6 // the indirect commands, their instance counts are written by the pass
+#define CULL_BOUNDS_BINDING   7 // mesh-space AABB per command
+#define CULL_COUNTERS_BINDING 8
+#define FRUSTUM_CULL_READBACKS 3 // visible counts are read this many frames late at most, never waited for
+
+// Mesh-space bounds of an indirect command's mesh as the cull pass reads them (std430)
+typedef struct CullBounds {
+    glm::vec4 min_corner;
+    glm::vec4 max_corner;
+} CullBounds;
+
+typedef struct CullStats {
+    std::size_t visible = 0;
+    std::size_t culled = 0;
+} CullStats;
+
+// Frustum culling of instances against the camera: on the GPU by a compute pass writing the indirect
+// commands directly, or on the CPU (is_visible()) where compute shaders are not available.
+class FrustumCuller : private NonCopyable {
+public:
+    FrustumCuller(); // prepares the compute pass if the context has compute shaders
+    ~FrustumCuller();
+
+    bool gpu_available() const;
+
+    // Dispatches the pass over n_instances, the buffers must be bound at the CULL_* bindings and INSTANCE_DATA_BINDING.
+    // n_cullable of them belong to commands, only those are counted.
+    void cull(GLsizei n_instances, std::size_t n_cullable, const glm::mat4& view_projection);
+    std::optional<CullStats> poll(); // counts of the newest finished pass, if there is one
+
+    // Conservative test: false only if all corners of the box are outside one clip plane
+    static bool is_visible(const glm::mat4& model_view_projection, const AABB& bounds);
+private:
+    std::unique_ptr<ShaderProgram> cull_shader;
+    GLuint counter_buffer = 0;
+    GLuint readback_buffer = 0; // FRUSTUM_CULL_READBACKS counts, persistently mapped
+    const GLuint* readback = nullptr;
+    std::array<GLsync, FRUSTUM_CULL_READBACKS> fences{};
+    std::array<std::size_t, FRUSTUM_CULL_READBACKS> cullable{};
+    std::uint64_t n_issued = 0;
+    std::uint64_t n_read = 0;
+
+    static constexpr UniformId instance_count_id{ "uInstanceCount" };
+    static constexpr UniformId view_projection_id{ "uViewProjection" };
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+
+#include <GL/glew.h>
+
+#include "utils/NonCopyable.hpp"
+
+#define GEOMETRY_BUFFER_VERTICES (256 * 1024)  // default capacity, 8 MiB of vertices
+#define GEOMETRY_BUFFER_INDICES  (1024 * 1024) // default capacity, 4 MiB of indices
+
+// Where a mesh lives in the geometry buffer, as the indexed draw calls take it
+typedef struct GeometryRange {
+    GLuint first_index; // counted from the start of the buffer (the element buffer of the shared VAO)
+    GLsizei index_count;
+    GLint base_vertex;
+} GeometryRange;
+
+// Layout of glMultiDrawElementsIndirect commands
+typedef struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+} DrawElementsIndirectCommand;
+
+// One immutable buffer holding the vertices and indices of many meshes, with one VAO over all of them.
+// Meshes are appended and stay until the buffer is destroyed. Draws of meshes in it never switch the VAO
+// and can be merged into a single multi-draw.
+class GeometryBuffer : private NonCopyable {
+public:
+    GeometryBuffer(GLsizei max_vertices = GEOMETRY_BUFFER_VERTICES, GLsizei max_indices = GEOMETRY_BUFFER_INDICES);
+    ~GeometryBuffer();
+
+    // Copies vertices (of the Vertex layout) and GLuint indices from the given buffers, on the GPU.
+    // std::nullopt if they do not fit.
+    std::optional<GeometryRange> allocate(GLuint vertex_buffer, GLsizei n_vertices, GLuint index_buffer, GLsizei n_indices);
+    GLuint get_vao() const;
+private:
+    GLuint buffer = 0;
+    GLuint vao = 0;
+    GLsizei max_vertices;
+    GLsizei max_indices;
+    GLintptr index_offset;  // the index region follows the vertex region
+    GLsizei n_vertices = 0; // allocated
+    GLsizei n_indices = 0;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+#include <GL/glew.h>
+
+#define GL_STATE_TEXTURE_UNITS 32 // units tracked, binds to higher ones always reach GL
+
+// Thin cache of the binding state the scenes change per draw: skips binds of what is already bound.
+// The state is per thread, like the GL context current on it. Code binding behind its back
+// (ImGui, raw gl* calls) has to invalidate() it before the cached functions are used again.
+namespace GlState {
+    typedef struct Counters {
+        std::size_t draws = 0;
+        std::size_t binds = 0;         // bind requests, redundant ones included
+        std::size_t state_changes = 0; // binds that reached GL
+    } Counters;
+
+    void use_program(GLuint program);
+    void bind_vertex_array(GLuint vertex_array);
+    void bind_texture_unit(GLuint unit, GLuint texture);
+    void count_draw();
+
+    // Deleted objects leave their bindings, a new object may get the same name
+    void program_deleted(GLuint program);
+    void vertex_array_deleted(GLuint vertex_array);
+    void texture_deleted(GLuint texture);
+
+    void invalidate(); // forget everything, the next bind of each kind reaches GL
+    void reset_counters();
+    Counters counters();
+}
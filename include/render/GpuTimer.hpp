@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include <GL/glew.h>
+
+#include "utils/NonCopyable.hpp"
+
+#define GPU_TIMER_QUERIES 4 // results are read this many frames late at most, never waited for
+
+// GL_TIME_ELAPSED queries in a ring: begin()/end() around a pass every frame, poll_ms() later on.
+// Query objects are not shared between contexts, create, use and delete the timer on one context.
+class GpuTimer : private NonCopyable {
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    void begin(); // skipped while every query still waits for its result
+    void end();
+    std::optional<double> poll_ms(); // the oldest finished measurement, if there is one
+private:
+    std::array<GLuint, GPU_TIMER_QUERIES> queries{};
+    std::uint64_t n_issued = 0; // queries ended
+    std::uint64_t n_read = 0;   // results taken
+    bool running = false;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "assets/Mesh.hpp"
+#include "render/Model.hpp"
+#include "render/RenderQueue.hpp"
+#include "render/GeometryBuffer.hpp"
+#include "render/FrustumCuller.hpp"
+#include "render/ShaderProgram.hpp"
+#include "render/Texture.hpp"
+#include "utils/NonCopyable.hpp"
+
+#define INSTANCE_DATA_BINDING 4 // shader storage block with the per-instance data
+
+// Per-instance data as the instanced shaders read it (std430)
+typedef struct InstanceData {
+    glm::mat4 model;
+    GLint texture_index; // into the TextureResidency, -1 if the group binds its texture
+    GLint draw_index;    // indirect command of the instance when the GPU culls, else -1
+    GLint padding[2];
+} InstanceData;
+
+// Collects many placed models per frame and queues every (mesh, shader, texture) group as one instanced draw.
+// The per-instance data of all groups goes into one shader storage buffer, each group starts at its own base instance.
+// Every shader of the models needs an instanced variant, which reads its model matrix from that buffer.
+// Groups of meshes in a GeometryBuffer with no texture to bind go further: one indirect command each,
+// a single multi-draw per shader (and primitive type). Their instances are frustum culled, on the GPU by default:
+// a compute pass fills the commands, so the CPU never tests or counts them.
+class InstanceBatcher : private NonCopyable {
+public:
+    enum class Culling {
+        gpu, // compute pass, counts arrive a few frames late
+        cpu, // fallback without compute shaders, only the visible instances are uploaded
+        off,
+    };
+
+    InstanceBatcher();
+    ~InstanceBatcher();
+
+    void set_culling(Culling culling); // gpu falls back to cpu when unavailable
+    Culling get_culling() const;
+    CullStats get_cull_stats() const;  // instances of the multi-draws, newest known
+
+    void set_instanced_shader(const ShaderProgram* shader, std::shared_ptr<ShaderProgram> instanced_shader);
+
+    void begin(); // forget the last frame's instances, keep their memory
+    void add(const Model& model, const glm::mat4& model_matrix);
+    void draw(RenderQueue& queue, const glm::mat4& view_projection); // culls and uploads the instances, queues the draws
+
+    std::size_t get_instance_count() const; // of the last draw(), before culling
+    std::size_t get_draw_count() const;     // draw calls queued, a multi-draw counts once
+
+private:
+    typedef struct GroupKey {
+        Mesh* mesh;
+        ShaderProgram* shader;
+        Texture* texture;
+        bool operator==(const GroupKey&) const = default;
+    } GroupKey;
+    struct GroupKeyHash {
+        std::size_t operator()(const GroupKey& key) const {
+            std::size_t hash = std::hash<const void*>{}(key.mesh);
+            hash = hash * 31 + std::hash<const void*>{}(key.shader);
+            return hash * 31 + std::hash<const void*>{}(key.texture);
+        }
+    };
+    typedef struct Group {
+        GroupKey key;
+        std::vector<InstanceData> instances;
+    } Group;
+    typedef struct MultiDraw {
+        ShaderProgram* shader;
+        GLuint vertex_array;
+        GLenum primitive_type;
+        std::vector<DrawElementsIndirectCommand> commands;
+        std::vector<CullBounds> bounds; // per command
+        std::size_t first_command;      // in the indirect buffer
+    } MultiDraw;
+    // How a group is drawn this frame
+    typedef struct Route {
+        ShaderProgram* shader;   // instanced variant, nullptr = not drawn
+        Texture* texture;        // to bind, nullptr if none
+        int multi_draw;          // index into multi_draws, -1 = its own instanced draw
+        std::size_t command;     // within the multi-draw
+    } Route;
+
+    std::vector<Group> groups; // kept across frames, the groups rarely change
+    std::unordered_map<GroupKey, std::size_t, GroupKeyHash> group_index;
+    std::unordered_map<const ShaderProgram*, std::shared_ptr<ShaderProgram>> instanced_shaders;
+
+    std::vector<Route> routes;         // per group
+    std::vector<InstanceData> staging; // all groups, one after another
+    GLuint buffer = 0;
+    GLuint culled_buffer = 0;          // the GPU cull pass output, read by the shaders instead of buffer
+    std::size_t buffer_capacity = 0;   // in instances
+
+    std::vector<MultiDraw> multi_draws; // kept across frames like the groups
+    std::vector<DrawElementsIndirectCommand> indirect_staging;
+    std::vector<CullBounds> bounds_staging;
+    GLuint indirect_buffer = 0;
+    GLuint bounds_buffer = 0;
+    std::size_t indirect_capacity = 0; // in commands
+
+    FrustumCuller culler;
+    Culling culling = Culling::gpu;
+    CullStats cull_stats;
+
+    int multi_draw_for(ShaderProgram* shader, const Mesh& mesh);
+    std::size_t n_instances = 0;
+    std::size_t n_draws = 0;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <GL/glew.h>
+
+// A block-compressed image with its whole mip chain, as stored in the texture cache
+typedef struct CompressedImage {
+    GLenum internal_format; // GL_COMPRESSED_RGBA_BPTC_UNORM, GL_COMPRESSED_RGB8_ETC2 or GL_COMPRESSED_RGBA8_ETC2_EAC
+    int width;
+    int height;
+    std::vector<std::vector<std::uint8_t>> levels; // level 0 (the largest) first
+} CompressedImage;
+
+// The KTX2 subset the texture cache uses: 2D, one layer, one face, no supercompression, BC7 or ETC2 blocks.
+// Only file I/O, no GL calls (safe on any thread).
+namespace Ktx2 {
+    std::optional<CompressedImage> read(const std::filesystem::path& path); // prints why on failure
+    bool write(const std::filesystem::path& path, const CompressedImage& image);
+
+    std::size_t block_bytes(GLenum internal_format); // 0 for formats the cache does not use
+    std::size_t level_bytes(GLenum internal_format, int width, int height); // 4x4 blocks, partial ones included
+
+    // resources/textures/cache/<file name>.ktx2 next to resources/textures/<file name>
+    std::filesystem::path cache_path(const std::filesystem::path& source);
+    bool is_cache_fresh(const std::filesystem::path& source); // exists and was baked after the source last changed
+}
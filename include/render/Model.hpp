@@ -16,6 +16,9 @@
 #include "assets/Mesh.hpp"
 #include "render/ShaderProgram.hpp"
 #include "render/Texture.hpp"
+#include "render/TextureResidency.hpp"
+#include "render/RenderQueue.hpp"
+#include "utils/Profiler.hpp"
 
 class Model {
 private:
@@ -26,7 +29,11 @@ private:
 
     glm::mat4 local_model_matrix{ 1.0 }; //cache, and for complex transformations (default = identity)
 
-    glm::mat4 create_MM(const glm::vec3& origin, const glm::vec3& e_ang, const glm::vec3& scale) {
+    // uniforms set on every draw
+    static constexpr UniformId model_matrix_id{ "uM_m" };
+    static constexpr UniformId texture_index_id{ "uTexIndex" };
+
+    glm::mat4 create_MM(const glm::vec3& origin, const glm::vec3& e_ang, const glm::vec3& scale) const {
         // keep angles in proper range
         glm::vec3 eA{ wrap_angle(e_ang.x), wrap_angle(e_ang.y), wrap_angle(e_ang.z) };
 
@@ -37,7 +44,7 @@ private:
         return s * rotm * t;
     }
 
-    float wrap_angle(float angle) { // wrap any float to [0, 360)
+    float wrap_angle(float angle) const { // wrap any float to [0, 360)
         angle = std::fmod(angle, 360.0f);
         if (angle < 0.0f) {
             angle += 360.0f;
@@ -66,6 +73,8 @@ public:
         glm::vec3 origin;                   // mesh origin relative to origin of the whole model
         glm::vec3 euler_angles;              // mesh rotation relative to orientation of the whole model
         glm::vec3 scale;                    // mesh scale relative to scale of the whole model
+        int texture_index = -1;             // index of the texture in a TextureResidency, -1 = bound per draw
+        glm::mat4 mesh_matrix{ 1.0f };      // origin, euler_angles and scale combined
     } MeshPackage;
     std::vector<MeshPackage> meshes;
 
@@ -120,6 +129,19 @@ public:
         glm::vec3 scale = glm::vec3(1.0f)       // dafault value
         ) {
         meshes.emplace_back(mesh, shader, texture, origin, euler_angles, scale);
+        meshes.back().mesh_matrix = create_MM(origin, euler_angles, scale);
+    }
+
+    // The model matrix set_position() would produce, without changing the model (for drawing one model many times)
+    glm::mat4 get_model_matrix_at(const glm::vec3& position) const {
+        return create_MM(position, euler_angles, scale);
+    }
+
+    // Resident textures are then picked by index in the shader, without binding them per mesh
+    void use_residency(const TextureResidency& residency) {
+        for (auto& mesh_pkg : meshes) {
+            mesh_pkg.texture_index = mesh_pkg.texture ? residency.index_of(mesh_pkg.texture.get()) : -1;
+        }
     }
 
     // update based on running time
@@ -129,28 +151,35 @@ public:
         //       use lambda funtion, call scripting language, etc. 
     }
 
-    void draw(const glm::mat4& view_matrix, const glm::mat4& projection_matrix) {
+    // The view and projection come from the frame's CameraUniforms
+    void draw() {
+        PROFILE_ZONE("Model::draw");
         // call draw() on mesh (all meshes)
         for (auto const& mesh_pkg : meshes) {
             mesh_pkg.shader->use(); // select proper shader
 
-            // Set view and projection matrices
-            mesh_pkg.shader->set_uniform("uV_m", view_matrix);
-            mesh_pkg.shader->set_uniform("uP_m", projection_matrix);
-
-            // Bind the texture
-            if (mesh_pkg.texture) {
+            // Select or bind the texture
+            if (mesh_pkg.texture_index >= 0) {
+                mesh_pkg.shader->set_uniform(texture_index_id, mesh_pkg.texture_index);
+            }
+            else if (mesh_pkg.texture) {
                 mesh_pkg.texture->bind();
             }
 
-            // Calculate and set model matrix
-            glm::mat4 mesh_model_matrix = create_MM(mesh_pkg.origin, mesh_pkg.euler_angles, mesh_pkg.scale);
-            mesh_pkg.shader->set_uniform("uM_m", mesh_model_matrix * local_model_matrix);
+            // Set model matrix
+            mesh_pkg.shader->set_uniform(model_matrix_id, mesh_pkg.mesh_matrix * local_model_matrix);
 
             mesh_pkg.mesh->draw();   // draw mesh
         }
     }
 
+    // Same as draw(), but queued: the queue orders the meshes with everything else drawn in the frame
+    void submit(RenderQueue& queue) const {
+        for (auto const& mesh_pkg : meshes) {
+            queue.submit(mesh_pkg.shader.get(), mesh_pkg.texture.get(), mesh_pkg.mesh.get(), mesh_pkg.mesh_matrix * local_model_matrix, mesh_pkg.texture_index);
+        }
+    }
+
 #pragma region Bounding box
     AABB get_local_AABB() const {
         bool first = true;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <GL/glew.h>
+
+#include "utils/NonCopyable.hpp"
+
+#define PIXEL_UPLOAD_RING_SLOTS 3 // uploads in flight before the oldest slot must be finished
+
+// Persistently mapped, coherent pixel unpack buffer, split into slots for streaming texture uploads.
+// The CPU writes a frame straight into a slot, the GPU copies it into the texture asynchronously and
+// a fence per slot keeps the CPU from overwriting it before that copy is done.
+class PixelUploadRing : private NonCopyable {
+public:
+    typedef struct Slot {
+        cv::Mat image;     // header over the mapped memory of the slot, rows aligned like GL_UNPACK_ALIGNMENT 4 expects
+        GLintptr offset;   // the same slot, as an offset into the buffer for the glTextureSubImage* pointer argument
+        std::size_t index;
+    } Slot;
+
+    PixelUploadRing(int cols, int rows, int type, std::size_t n_slots = PIXEL_UPLOAD_RING_SLOTS); // sized for one frame per slot
+    ~PixelUploadRing();
+
+    GLuint get_name() const;
+    Slot acquire(int cols, int rows, int type); // the next slot, waits while the GPU still reads it
+    void release(const Slot& slot);             // after the upload command using the slot was issued
+private:
+    GLuint name_ = 0;
+    std::byte* mapped = nullptr;
+    std::size_t slot_size;
+    std::size_t next_slot = 0;
+    std::vector<GLsync> fences;
+
+    static std::size_t row_step(int cols, int type);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "assets/Mesh.hpp"
+#include "render/ShaderProgram.hpp"
+#include "render/Texture.hpp"
+
+// One draw call: of a mesh, plain (model matrix as uM_m) or instanced (per-instance data in a bound buffer),
+// or a multi-draw of indirect commands over the meshes of a GeometryBuffer
+typedef struct DrawItem {
+    std::uint64_t key;          // shader, then texture, then vertex array: sorted items share as many binds as possible
+    ShaderProgram* shader;
+    Texture* texture;           // bound before the draw, nullptr if none (or resident)
+    Mesh* mesh;                 // nullptr for multi-draws
+    glm::mat4 model_matrix;     // plain draws only
+    GLint texture_index;        // plain draws only, into the TextureResidency, -1 = none
+    GLsizei instance_count;     // instanced draws only, 0 = a plain draw
+    GLuint base_instance;
+    GLuint vertex_array;        // multi-draws only: the GeometryBuffer's VAO
+    GLenum primitive_type;
+    GLuint indirect_buffer;     // multi-draws only: draw_count commands at indirect_offset
+    GLintptr indirect_offset;
+    GLsizei draw_count;
+} DrawItem;
+
+// Collects the draws of a frame, then issues them sorted by state, binding through GlState so
+// consecutive draws with the same shader, texture or mesh do not bind them again.
+class RenderQueue {
+public:
+    void submit(ShaderProgram* shader, Texture* texture, Mesh* mesh, const glm::mat4& model_matrix, GLint texture_index = -1);
+    void submit_instanced(ShaderProgram* shader, Texture* texture, Mesh* mesh, GLsizei instance_count, GLuint base_instance);
+    void submit_multi_draw(ShaderProgram* shader, Texture* texture, GLuint vertex_array, GLenum primitive_type, GLuint indirect_buffer, GLintptr indirect_offset, GLsizei draw_count);
+    void flush(); // draws and forgets every submitted item, keeps the memory
+
+    static std::uint64_t sort_key(const ShaderProgram* shader, const Texture* texture, GLuint vertex_array);
+private:
+    std::vector<DrawItem> items;
+
+    static constexpr UniformId model_matrix_id{ "uM_m" };
+    static constexpr UniformId texture_index_id{ "uTexIndex" };
+};
@@ -1,15 +1,31 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include "render/GlState.hpp"
 #include "utils/NonCopyable.hpp"
 
+// Name of a uniform, hashed at compile time (FNV-1a): static constexpr UniformId model_matrix_id{ "uM_m" };
+// Setting a uniform by id neither allocates nor hashes a string, the program looks its location up by the hash.
+struct UniformId {
+    std::uint32_t hash;
+
+    constexpr explicit UniformId(std::string_view name) : hash(2166136261u) {
+        for (char c : name) {
+            hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
+        }
+    }
+};
+
 class ShaderProgram : private NonCopyable {
 public:
     // No default constructor. RAII - if constructed, it will be correctly initialized
@@ -21,30 +37,26 @@ public:
     // you can add more constructors for pipeline with GS, TS etc.
     ShaderProgram(std::string const & vertex_shader_code, std::string const & fragment_shader_code);
     ShaderProgram(std::filesystem::path const & VS_file, std::filesystem::path const & FS_file);
+    explicit ShaderProgram(std::filesystem::path const & CS_file); // compute shader
 
-    // activate shader
+    // activate shader (skipped if already being used)
     void use(void) {  
-        if (ID==currently_used_ID) // already being used
-            return;
-        else {
-            glUseProgram(ID);
-            currently_used_ID = ID;
-        }
+        GlState::use_program(ID);
     };
 
     // deactivate current shader program (i.e. activate shader no. 0)
     void deactivate(void) { 
-        glUseProgram(0); 
-        currently_used_ID = 0; 
+        GlState::use_program(0);
     };   
 
     ~ShaderProgram(void) {  //deallocate shader program
         deactivate();
         glDeleteProgram(ID);
+        GlState::program_deleted(ID);
         ID = 0;
     }
     
-    GLuint get_ID(void) { return ID; }
+    GLuint get_ID(void) const { return ID; }
     GLint  get_attrib_location(const std::string & name);
     
     // set uniform according to name 
@@ -59,11 +71,22 @@ public:
     void set_uniform(const std::string & name, const std::vector<GLfloat> & val);
     void set_uniform(const std::string & name, const std::vector<glm::vec3> & val);
 
+    // set uniform according to its compile-time id (locations reflected at link time)
+    // unknown ids resolve to -1, which GL ignores: e.g. uniforms the compiler optimized out
+    GLint get_uniform_location(UniformId id) const;
+    void set_uniform(UniformId id, const GLfloat val)     { glProgramUniform1f(ID, get_uniform_location(id), val); }
+    void set_uniform(UniformId id, const GLint val)       { glProgramUniform1i(ID, get_uniform_location(id), val); }
+    void set_uniform(UniformId id, const glm::vec3 & val) { glProgramUniform3fv(ID, get_uniform_location(id), 1, &val[0]); }
+    void set_uniform(UniformId id, const glm::vec4 & val) { glProgramUniform4fv(ID, get_uniform_location(id), 1, &val[0]); }
+    void set_uniform(UniformId id, const glm::mat3 & val) { glProgramUniformMatrix3fv(ID, get_uniform_location(id), 1, GL_FALSE, &val[0][0]); }
+    void set_uniform(UniformId id, const glm::mat4 & val) { glProgramUniformMatrix4fv(ID, get_uniform_location(id), 1, GL_FALSE, &val[0][0]); }
 
 private:
     GLuint ID{0}; // default = 0, empty shader
-    inline static GLuint currently_used_ID{0};
     std::unordered_map<std::string, GLuint> uniform_location_cache;
+    std::vector<std::pair<std::uint32_t, GLint>> uniform_locations; // (UniformId hash, location), sorted by hash
+
+    void reflect_uniforms(); // fills both caches with every active uniform outside of blocks
 
     GLuint get_uniform_location(const std::string & name);
 
@@ -1,27 +1,43 @@
 #pragma once 
 
 #include <filesystem>
+#include <memory>
+#include <variant>
 
 #include <opencv2/opencv.hpp>
 #include <GL/glew.h> 
 #include <glm/glm.hpp>
 
 #include "utils/NonCopyable.hpp"
+#include "render/Ktx2.hpp"
+
+class PixelUploadRing;
 
 class Texture : private NonCopyable {
 public:
     enum class Interpolation {
         nearest,
         linear,
-        linear_mipmap_linear,
+        linear_mipmap_linear, // the only one allocating a mip chain, the others have a single level
+    };
+    // When the mip chain follows a new image
+    enum class MipUpdate {
+        on_upload, // regenerated by every replace_image (static images)
+        on_demand, // only marked stale, update_mipmaps() regenerates it before a minified draw (streamed images)
+    };
+    // Where the first row of the uploaded images ends up
+    enum class Origin {
+        bottom_left, // images are flipped on upload, v = 1 is their top row (the usual OpenGL texture coordinates)
+        top_left,    // images are uploaded as they are, v = 0 is their top row: whoever samples flips v instead
     };
 
     Texture();
-    Texture(int cols, int rows, int type, Interpolation interpolation = Interpolation::linear_mipmap_linear);
+    Texture(int cols, int rows, int type, Interpolation interpolation = Interpolation::linear_mipmap_linear, Origin origin = Origin::bottom_left, MipUpdate mip_update = MipUpdate::on_upload);
     Texture(const cv::Mat& image, Interpolation interpolation = Interpolation::linear_mipmap_linear); // default = best texture filtering
     Texture(const glm::vec3& vec); // synthetic single-color RGB texture
     Texture(const glm::vec4& vec); // synthetic single-color RGBA texture
     Texture(const std::filesystem::path& path, Interpolation interpolation = Interpolation::linear_mipmap_linear);
+    Texture(const CompressedImage& image, Interpolation interpolation = Interpolation::linear_mipmap_linear); // uses the baked mip chain as it is
 
     ~Texture();
 
@@ -30,10 +46,37 @@ public:
     int get_height(void);
     int get_width(void);
     void set_interpolation(Interpolation interpolation);
+    void update_mipmaps(); // no-op unless the chain is stale
+    Origin get_origin() const;
+    // Texture coordinates of the image's top-left and bottom-right corners, for drawing it upright (e.g. ImGui::Image)
+    glm::vec2 uv_top_left() const;
+    glm::vec2 uv_bottom_right() const;
     void replace_image(const cv::Mat& image);
+    void replace_image(const cv::Mat& image, PixelUploadRing& ring); // streamed through a mapped buffer
+    static cv::Mat load_image(const std::filesystem::path& path); // decode only, no GL calls (safe on any thread)
+
+    // Decoded pixels, or compressed blocks from the texture cache
+    typedef std::variant<cv::Mat, CompressedImage> Image;
+    static Image load_image_cached(const std::filesystem::path& path); // the baked KTX2 if it is up to date, else load_image(); no GL calls
+    static std::shared_ptr<Texture> create(const Image& image, Interpolation interpolation = Interpolation::linear_mipmap_linear);
+    static std::shared_ptr<Texture> load(const std::filesystem::path& path); // load_image_cached() + create(), on the GL thread
+    std::size_t get_memory_bytes() const; // all levels, as the format defines them (drivers may pad)
+    void release_storage(); // frees the GL texture once its pixels are kept elsewhere (TextureResidency array), binds nothing afterwards
 private:
-    cv::Mat load_image(const std::filesystem::path& path);
     static void gen_ckboard(void);  // create default texture
     static inline GLuint ckboard_; // class-shared ckboard variable. Initialized lazily.
     GLuint name_; // set default-constructed texture to ckboard pattern
+    // The storage is immutable, so its metadata is known without asking the driver
+    int width_ = 2;
+    int height_ = 2;
+    GLenum internal_format_ = GL_RGB8;
+    Origin origin_ = Origin::bottom_left;
+    GLsizei levels_ = 1;
+    MipUpdate mip_update_ = MipUpdate::on_upload;
+    bool mips_stale_ = false;
+
+    void image_replaced();
+
+    void check_replacement(const cv::Mat& image) const;
+    GLenum pixel_format() const;
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "render/Texture.hpp"
+#include "utils/NonCopyable.hpp"
+
+#define TEXTURE_ARRAY_LAYER_SIZE 1024 // every texture is resampled to this size in the array
+#define TEXTURE_ARRAY_UNIT 0
+#define TEXTURE_HANDLES_BINDING 3     // shader storage block with the bindless handles
+
+// Keeps a set of scene textures resident for the whole frame, the shader picks one by index (uTexIndex)
+// instead of a bind per draw. Bindless handles where ARB_bindless_texture is available, layers of one
+// GL_TEXTURE_2D_ARRAY otherwise. Each mode has its own fragment shader, see fragment_shader_path().
+// In array mode the added textures are copied into the layers and their own storage is released: they cannot be bound afterwards.
+class TextureResidency : private NonCopyable {
+public:
+    enum class Mode {
+        bindless,
+        array,
+    };
+
+    TextureResidency();
+    ~TextureResidency();
+
+    Mode get_mode() const;
+    std::filesystem::path fragment_shader_path() const;
+
+    int add(const std::shared_ptr<Texture>& texture); // the index, the same one for a texture added again
+    int index_of(const Texture* texture) const;       // -1 when not added
+    void make_resident();                             // after all textures are added
+    void bind() const;                                // once per frame, before drawing
+
+private:
+    Mode mode;
+    std::vector<std::shared_ptr<Texture>> textures; // kept alive as long as they are resident (their addresses are the indices' keys)
+    std::unordered_map<const Texture*, int> indices;
+
+    GLuint array_name = 0;          // array mode
+    std::vector<GLuint64> handles;  // bindless mode
+    GLuint handle_buffer = 0;
+
+    void build_array();
+    void build_handles();
+};
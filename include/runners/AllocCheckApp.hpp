@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#include <opencv2/opencv.hpp>
+
+// Counts heap allocations per frame in the tracker's detection stage, after a warm-up.
+// Our own stages (pyramid, red kernel) must not allocate at all, OpenCV's (color conversion, Haar cascade) are reported.
+class AllocCheckApp {
+public:
+	AllocCheckApp();
+	bool init(void);
+	int run(void);
+	~AllocCheckApp();
+
+private:
+	std::string image_path = "resources/red_cup.jpg";
+	int n_warmup_frames = 10;
+	int n_frames = 100;
+	float face_scale = 0.5f;
+	float red_scale = 0.25f;
+	cv::Mat image;
+
+	void print_stage(const std::string& name, std::size_t n_allocations, bool must_be_zero);
+};
@@ -4,18 +4,30 @@
 #include <vector>
 #include <thread>
 #include <string>
+#include <optional>
+#include <cstdint>
+#include <stop_token>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <opencv2/opencv.hpp>
 
 #include "scenes/IScene.hpp"
+#include "capture/FrameSource.hpp"
 #include "render/SyncedTexture.hpp"
-#include "concurrency/SyncedDeque.hpp"
+#include "render/GpuTimer.hpp"
+#include "render/GlState.hpp"
+#include "concurrency/SpscRing.hpp"
+#include "concurrency/Mailbox.hpp"
+#include "concurrency/WaitSignal.hpp"
 #include "concurrency/Pool.hpp"
 #include "recognizers/FaceRecognizer.hpp"
 #include "recognizers/RedRecognizer.hpp"
 #include "utils/FpsMeter.hpp"
+#include "utils/FrameTimeHistory.hpp"
+
+// More than the pool can ever hand out, so the tracker never finds the ring full
+#define TRACKER_QUEUE_CAPACITY 8
 
 class GLApp {
 public:
@@ -48,6 +60,7 @@ private:
 	std::string gl_version;
 	std::string gl_profile;
 	void show_crosshair();
+	void show_frame_times();
 
 	// callbacks
 	static void glfw_error_callback(int error, const char* description);
@@ -59,25 +72,79 @@ private:
 
 	// Camera tracking
 	typedef struct RecognizedData {
-		std::unique_ptr<SyncedTexture> frame;
-		std::vector<cv::Point2f> faces;
+		Lease<SyncedTexture> frame; // goes back to frame_pool when the data is dropped
+		FaceCenters faces;
 		cv::Point2f red;
+		float upload_gpu_ms = -1.0f; // latest finished upload measurement, negative if none yet
 	} RecognizedData;
+	Pool<SyncedTexture> frame_pool; // declared before everything holding its leases
 	RecognizedData default_recognized_data;
-	SyncedDeque<RecognizedData> de_queue;
-	Pool<SyncedTexture> frame_pool;
+	enum class TrackerChannel {
+		queue,   // every frame is shown, in order
+		mailbox, // only the newest frame is shown, stale ones go back to the pool
+	};
+	TrackerChannel tracker_channel = TrackerChannel::mailbox;
+	SpscRing<RecognizedData, TRACKER_QUEUE_CAPACITY> de_queue; // tracker thread -> render loop
+	Mailbox<RecognizedData> mailbox;                            // tracker thread -> render loop
+	std::atomic<std::size_t> queue_dropped_frames = 0;
 	std::atomic<bool> ended_main = false;
 	std::atomic<bool> ended_tracker_thread = false;
-	std::jthread tracker_thread;
-	FaceRecognizer face_recognizer;
-	RedRecognizer red_recognizer;
-	cv::VideoCapture capture_device;
+	FrameSourceConfig frame_source_config; // "source" in the config
+	std::unique_ptr<FrameSource> frame_source;
 	int camera_width, camera_height;
 
-	void tracker_worker();
+	// Tracker pipeline: capture -> N parallel detections on the task scheduler -> upload (owns the shared GL context)
+	// Frames go round the detector lanes in capture order, so the upload stage takes them back in order without any buffering.
+	// A lane keeps its buffers (camera image, pyramid, face workspace) from frame to frame, only OpenCV (cvtColor, the cascade) still allocates every frame.
+	enum class LaneState : std::uint32_t {
+		free,      // capture may fill it
+		detecting, // a scheduler task works on it
+		detected,  // waiting for upload
+	};
+	typedef struct DetectorLane { // cv::CascadeClassifier must not be shared between threads
+		GLApp* app;
+		FaceRecognizer face_recognizer;
+		RedRecognizer red_recognizer;
+		DetectionFrame detection_frame;
+		FaceWorkspace face_workspace;
+		cv::Mat image;
+		FaceCenters faces;
+		cv::Point2f red;
+		std::atomic<LaneState> state{ LaneState::free };
+	} DetectorLane;
+	std::size_t n_detector_workers = 0; // frames detected in parallel, 0 = pick by core count
+	bool face_tracking_on = true;       // search around the last faces instead of the whole frame
+	int face_full_scan_interval = FACE_FULL_SCAN_INTERVAL;
+	float face_working_scale = 1.0f;    // detection resolution, as a fraction of the camera one
+	float red_working_scale = 1.0f;
+	std::vector<std::unique_ptr<DetectorLane>> detector_lanes;
+	WaitSignal lane_signal; // notified on every lane state change
+	std::stop_source tracker_stop;
+	std::jthread capture_thread;
+	std::jthread upload_thread;
+
+	void start_tracker();
+	void stop_tracker();
+	void capture_worker(std::stop_token stop);
+	static void run_detect_task(void* lane);
+	void detect_frame(DetectorLane& lane);
+	void upload_worker(std::stop_token stop);
+	void publish_recognized_data(RecognizedData&& recognized_data);
+	std::optional<RecognizedData> take_recognized_data();
+	std::size_t dropped_frames();
+	std::size_t dropped_faces(); // faces over FACE_MAX_FACES, summed over the detector lanes
 
 	// FPS tracker
 	FpsMeter FPS_main;
 	FpsMeter FPS_tracker;
 
+	// Frame times: CPU without the wait in swap, GPU per pass (scene, ImGui, camera upload on the tracker's context)
+	std::unique_ptr<GpuTimer> scene_gpu_timer;
+	std::unique_ptr<GpuTimer> imgui_gpu_timer;
+	FrameTimeHistory cpu_frame_times;
+	FrameTimeHistory scene_gpu_times;
+	FrameTimeHistory imgui_gpu_times;
+	FrameTimeHistory upload_gpu_times;
+	GlState::Counters scene_gl_counters; // draws and binds of the last scene render
+
 };
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Microbenchmark of the tracker -> render handoff: SyncedDeque vs. SpscRing
+class HandoffBenchApp {
+public:
+	HandoffBenchApp();
+	bool init(void);
+	int run(void);
+	~HandoffBenchApp();
+
+private:
+	typedef struct BenchResult {
+		std::string queue_name;
+		double rate_hz;
+		bool polling;
+		std::vector<double> push_us;    // time spent inside push_back on the producer
+		std::vector<double> latency_us; // push_back -> consumer wake-up and pop
+	} BenchResult;
+
+	std::chrono::duration<double> case_duration{ 5.0 };
+	std::vector<double> rates_hz{ 30.0, 300.0 }; // tracker frame rate and 10x that
+
+	// polling = consumer spins on try_pop_front like the render loop, otherwise it sleeps in wait()
+	template<typename Queue>
+	BenchResult run_case(const std::string& queue_name, double rate_hz, bool polling);
+	void print_result(const BenchResult& result);
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+// Checks the fused red kernel against the cvtColor + inRange reference and times both
+class RedBenchApp {
+public:
+	RedBenchApp();
+	bool init(void);
+	int run(void);
+	~RedBenchApp();
+
+private:
+	std::string image_path = "resources/red_cup.jpg";
+	int n_repeats = 50;
+	cv::Mat image;
+
+	bool check_case(const std::string& name, const cv::Mat& frame); // prints the result, true when the centroids are identical
+	void time_case(const std::string& name, const cv::Mat& frame);
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "render/Ktx2.hpp"
+
+// Bakes every image of the texture directory into the KTX2 texture cache (BC7 or ETC2 blocks, full mip chain),
+// then loads each texture both ways and compares the load time and GPU memory of the decode path with the cache.
+// The blocks are encoded by the GL driver, so a (hidden) GL context is needed.
+class TextureBakeApp {
+public:
+	TextureBakeApp();
+	bool init(void);
+	int run(void);
+	~TextureBakeApp();
+
+private:
+	// "texturebake" in the config
+	std::filesystem::path directory = "resources/textures";
+	std::string format = "bc7"; // or "etc2"
+
+	GLFWwindow* window = nullptr;
+
+	bool load_config(const std::string& filename);
+	std::optional<CompressedImage> bake(const std::filesystem::path& source);
+};
@@ -5,9 +5,10 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include "capture/FrameSource.hpp"
 #include "recognizers/FaceRecognizer.hpp"
 #include "recognizers/RedRecognizer.hpp"
-#include "concurrency/SyncedDeque.hpp"
+#include "concurrency/SpscRing.hpp"
 #include "utils/FpsMeter.hpp"
 
 class ThreadTrackApp {
@@ -20,12 +21,13 @@ public:
 	~ThreadTrackApp();
 
 private:
-	SyncedDeque<cv::Mat> de_queue;
+	SpscRing<cv::Mat, 8> de_queue;
+	std::size_t dropped_frames = 0; // tracker thread only
 	std::atomic<bool> ended_main = false;
     std::atomic<bool> ended_tracker_thread = false;
 	FaceRecognizer face_recognizer;
 	RedRecognizer red_recognizer;
-	cv::VideoCapture capture_device;
+	std::unique_ptr<FrameSource> frame_source;
 	cv::Mat static_image;
 	cv::Mat warning_image;
 	FpsMeter FPS_main;
@@ -2,6 +2,7 @@
 
 #include <opencv2/opencv.hpp>
 
+#include "capture/FrameSource.hpp"
 #include "recognizers/FaceRecognizer.hpp"
 #include "recognizers/RedRecognizer.hpp"
 #include "utils/FpsMeter.hpp"
@@ -16,7 +17,7 @@ public:
 private:
 	FaceRecognizer face_recognizer;
 	RedRecognizer red_recognizer;
-	cv::VideoCapture capture_device;
+	std::unique_ptr<FrameSource> frame_source;
 	cv::Mat static_image;
 	cv::Mat warning_image;
 	FpsMeter FPS;
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "capture/FrameSource.hpp"
+#include "recognizers/DetectionFrame.hpp"
+#include "recognizers/FaceRecognizer.hpp"
+#include "recognizers/RedRecognizer.hpp"
+#include "utils/LatencyStats.hpp"
+
+// Headless tracker benchmark: capture -> face -> red -> annotate -> encode over a replayed source, as fast as it goes.
+// Prints per-stage latency percentiles and throughput as JSON (and writes them to a file), to compare builds.
+class TrackBenchApp {
+public:
+	TrackBenchApp();
+	bool init(void);
+	int run(void);
+	~TrackBenchApp();
+
+private:
+	// "trackbench" in the config
+	int n_frames = 300;
+	int n_warmup_frames = 10;
+	std::string output_path = "trackbench.json";
+	int jpeg_quality = 90;
+	FrameSourceConfig source_config;
+
+	// tracker settings, same keys as the app
+	bool face_tracking_on = true;
+	int face_full_scan_interval = FACE_FULL_SCAN_INTERVAL;
+	float face_scale = 1.0f;
+	float red_scale = 1.0f;
+
+	std::unique_ptr<FrameSource> frame_source;
+	FaceRecognizer face_recognizer;
+	RedRecognizer red_recognizer;
+
+	typedef struct Stage {
+		std::string name;
+		LatencyStats latency;
+	} Stage;
+	enum StageIndex { capture_stage, pyramid_stage, face_stage, red_stage, annotate_stage, encode_stage, total_stage, n_stages };
+	std::vector<Stage> stages;
+
+	bool load_config(const std::string& filename);
+};
@@ -10,6 +10,11 @@
 #include "assets/Mesh.hpp"
 #include "render/Model.hpp"
 #include "render/Texture.hpp"
+#include "render/CameraUniforms.hpp"
+#include "render/RenderQueue.hpp"
+#include "render/TextureResidency.hpp"
+#include "render/InstanceBatcher.hpp"
+#include "render/GeometryBuffer.hpp"
 
 struct Target {
 	Model* model = nullptr;
@@ -74,6 +79,8 @@ private:
 
 	// Camera
 	Camera camera;
+	CameraUniforms camera_uniforms; // view, projection and position for all shaders, updated once per frame
+	RenderQueue render_queue;       // the frame's draws, sorted by state
 	double cursor_last_x{ 0 };
 	double cursor_last_y{ 0 };
 
@@ -81,9 +88,12 @@ private:
 	AudioManager audio_manager;
 
 	// Assets
+	GeometryBuffer geometry_buffer; // vertices and indices of all target meshes, drawn by multi-draws
 	std::unordered_map<std::string, std::shared_ptr<ShaderProgram>> shader_library;
 	std::unordered_map<std::string, std::shared_ptr<Mesh>> mesh_library;
 	std::unordered_map<std::string, std::shared_ptr<Texture>> texture_library;
+	std::unique_ptr<TextureResidency> texture_residency;
+	InstanceBatcher instance_batcher; // draws the targets, one instanced call per (mesh, shader, texture)
 
 	// Models
 	std::unordered_map<std::string, Model> models;
@@ -104,6 +114,7 @@ private:
 	// Targets
 	std::vector<Target> spawned_models;
 	void spawn_models(int count, const std::string& model_name);
+	void spawn_more_models(); // a crowd of every target type
 	float default_respawn_time = 5.0f;
 
 	// Shooting mechanics
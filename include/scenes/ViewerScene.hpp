@@ -10,6 +10,8 @@
 #include "assets/Mesh.hpp"
 #include "render/Model.hpp"
 #include "render/Texture.hpp"
+#include "render/CameraUniforms.hpp"
+#include "render/RenderQueue.hpp"
 
 class ViewerScene : public IScene {
 public:
@@ -37,6 +39,8 @@ private:
 
 	// Camera
 	Camera camera;
+	CameraUniforms camera_uniforms; // view, projection and position for all shaders, updated once per frame
+	RenderQueue render_queue;       // the frame's draws, sorted by state
 	double cursor_last_x{ 0 };
 	double cursor_last_y{ 0 };
 
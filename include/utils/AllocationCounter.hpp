@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts global operator new calls, from all threads. Only built with ICP_COUNT_ALLOCATIONS (the ALLOCCHECK run mode),
+// otherwise the counter stays 0 and the default allocator is used.
+namespace AllocationCounter {
+	bool enabled();
+	std::size_t count();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// Vector with the storage inside (no heap), for small per-frame results that are moved around a lot.
+// Elements past the capacity are dropped, push_back reports it.
+template<typename T, std::size_t Capacity>
+class FixedVector {
+public:
+	bool push_back(const T& value) {
+		if (n_elements == Capacity)
+			return false;
+		elements[n_elements++] = value;
+		return true;
+	}
+
+	void clear() { n_elements = 0; }
+	std::size_t size() const { return n_elements; }
+	bool empty() const { return n_elements == 0; }
+	static constexpr std::size_t capacity() { return Capacity; }
+
+	T& operator[](std::size_t index) { return elements[index]; }
+	const T& operator[](std::size_t index) const { return elements[index]; }
+
+	T* begin() { return elements.data(); }
+	T* end() { return elements.data() + n_elements; }
+	const T* begin() const { return elements.data(); }
+	const T* end() const { return elements.data() + n_elements; }
+
+private:
+	std::array<T, Capacity> elements{};
+	std::size_t n_elements = 0;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#define FRAME_TIME_HISTORY 240 // samples kept, about 4 s at 60 FPS
+
+// Rolling window of frame times (in milliseconds) for the ImGui graphs, never allocates.
+class FrameTimeHistory {
+public:
+	void add(float ms) {
+		samples[next] = ms;
+		next = (next + 1) % FRAME_TIME_HISTORY;
+		n_samples = std::min<std::size_t>(n_samples + 1, FRAME_TIME_HISTORY);
+	}
+
+	std::size_t count() const { return n_samples; }
+
+	// For ImGui::PlotLines: the ring in oldest-first order is values() starting at offset()
+	const float* values() const { return samples.data(); }
+	int offset() const { return static_cast<int>(next); }
+	int size() const { return FRAME_TIME_HISTORY; }
+
+	// Nearest-rank percentile of the window, p in [0, 1]
+	float percentile(float p) const {
+		if (n_samples == 0)
+			return 0.0f;
+		std::array<float, FRAME_TIME_HISTORY> sorted;
+		auto end = std::copy_n(samples.begin(), n_samples, sorted.begin()); // all recorded samples, the order does not matter
+		auto nth = sorted.begin() + std::min(static_cast<std::size_t>(p * (n_samples - 1) + 0.5f), n_samples - 1);
+		std::nth_element(sorted.begin(), nth, end);
+		return *nth;
+	}
+
+private:
+	std::array<float, FRAME_TIME_HISTORY> samples{};
+	std::size_t next = 0;
+	std::size_t n_samples = 0;
+};
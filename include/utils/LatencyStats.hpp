@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+// Collects latency samples (in microseconds) for percentile reports. reserve() up front to keep add() allocation-free.
+class LatencyStats {
+public:
+	void reserve(std::size_t n) { samples.reserve(n); }
+	void clear() { samples.clear(); }
+
+	void add(double us) { samples.push_back(us); }
+	void add(std::chrono::steady_clock::duration duration) {
+		add(std::chrono::duration<double, std::micro>(duration).count());
+	}
+
+	std::size_t count() const { return samples.size(); }
+
+	double mean() const {
+		return samples.empty() ? 0.0 : std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+	}
+
+	// Nearest-rank percentile, p in [0, 1]
+	double percentile(double p) const {
+		if (samples.empty())
+			return 0.0;
+		std::vector<double> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+		auto index = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	double max() const {
+		return samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+	}
+
+private:
+	std::vector<double> samples;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "concurrency/CacheLine.hpp"
+#include "utils/NonCopyable.hpp"
+
+#define PROFILER_EVENTS_PER_THREAD 65536 // ring per thread, the oldest zones are overwritten
+
+// Scoped-zone CPU profiler. Every thread records into its own ring buffer, lock-free, and the whole history
+// can be written as a Chrome / Perfetto trace (chrome://tracing, ui.perfetto.dev) at any time.
+// Use the macros: without ICP_PROFILING they compile to nothing.
+namespace Profiler {
+	typedef struct Event {
+		std::atomic<const char*> name{ nullptr }; // string literal
+		std::atomic<std::int64_t> begin_ns{ 0 };
+		std::atomic<std::int64_t> end_ns{ 0 };
+	} Event;
+
+	// Written only by its thread, read by write_chrome_trace() from any thread
+	struct ThreadBuffer : NonCopyable {
+		std::atomic<const char*> thread_name{ nullptr };
+		std::uint32_t thread_id = 0;
+		alignas(cache_line_size) std::atomic<std::uint64_t> n_events{ 0 };
+		std::array<Event, PROFILER_EVENTS_PER_THREAD> events;
+	};
+
+	bool enabled();
+	std::int64_t now_ns(); // since the profiler started
+	ThreadBuffer& thread_buffer(); // registers the calling thread on first use
+	void set_thread_name(const char* name);
+	bool write_chrome_trace(const std::string& path); // all threads, all recorded zones
+
+	inline void record(const char* name, std::int64_t begin_ns, std::int64_t end_ns) {
+		ThreadBuffer& buffer = thread_buffer();
+		std::uint64_t index = buffer.n_events.load(std::memory_order_relaxed);
+		Event& event = buffer.events[index % PROFILER_EVENTS_PER_THREAD];
+		event.name.store(name, std::memory_order_relaxed);
+		event.begin_ns.store(begin_ns, std::memory_order_relaxed);
+		event.end_ns.store(end_ns, std::memory_order_relaxed);
+		buffer.n_events.store(index + 1, std::memory_order_release);
+	}
+
+	class Zone : NonCopyable {
+	public:
+		explicit Zone(const char* name) : name(name), begin_ns(now_ns()) {}
+		~Zone() { record(name, begin_ns, now_ns()); }
+	private:
+		const char* name;
+		std::int64_t begin_ns;
+	};
+}
+
+#define ICP_PROFILE_CONCAT_(a, b) a##b
+#define ICP_PROFILE_CONCAT(a, b) ICP_PROFILE_CONCAT_(a, b)
+
+#ifdef ICP_PROFILING
+	#define PROFILE_ZONE(name) Profiler::Zone ICP_PROFILE_CONCAT(profile_zone_, __LINE__){ name }
+	#define PROFILE_THREAD(name) Profiler::set_thread_name(name)
+#else
+	#define PROFILE_ZONE(name) ((void)0)
+	#define PROFILE_THREAD(name) ((void)0)
+#endif
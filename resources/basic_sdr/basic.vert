@@ -1,9 +1,15 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 uP_m = mat4(1.0);
+// Written once per frame by CameraUniforms
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 uV_m;
+    mat4 uP_m;
+    vec4 uCameraPosition; // w unused
+};
+
 uniform mat4 uM_m = mat4(1.0);
-uniform mat4 uV_m = mat4(1.0);
 
 void main()
 {
@@ -0,0 +1,27 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+
+struct Instance
+{
+    mat4 model;
+    int texture_index;
+    int draw_index; // used by the cull pass
+};
+layout(std430, binding = 4) readonly buffer Instances
+{
+    Instance instances[]; // all instanced draws of the frame (visible ones, when culled), each starts at its base instance
+};
+
+// Written once per frame by CameraUniforms
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 uV_m;
+    mat4 uP_m;
+    vec4 uCameraPosition; // w unused
+};
+
+void main()
+{
+    // Outputs the positions/coordinates of all vertices
+    gl_Position = uP_m * uV_m * instances[gl_BaseInstance + gl_InstanceID].model * vec4(aPos, 1.0f);
+}
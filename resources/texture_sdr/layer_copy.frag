@@ -0,0 +1,12 @@
+#version 460 core
+in vec2 texcoord;
+
+uniform sampler2D tex0; // the source texture, unit 0
+
+out vec4 FragColor;
+
+void main()
+{
+    // Resampled into the array layer, larger sources are read from their matching mip level
+    FragColor = texture(tex0, texcoord);
+}
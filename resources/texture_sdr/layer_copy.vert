@@ -0,0 +1,11 @@
+#version 460 core
+
+out vec2 texcoord;
+
+void main()
+{
+    // One triangle covering the whole viewport, no vertex buffer
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    texcoord = position;
+    gl_Position = vec4(position * 2.0f - 1.0f, 0.0f, 1.0f);
+}
@@ -2,6 +2,7 @@
 in VS_OUT
 {
     vec2 texcoord;
+    flat int texture_index; // unused, tex0 is bound
 } fs_in;
 
 uniform sampler2D tex0; // texture unit from C++
@@ -3,13 +3,21 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNorm;
 layout (location = 2) in vec2 aTex;
 
-uniform mat4 uP_m = mat4(1.0f);
+// Written once per frame by CameraUniforms
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 uV_m;
+    mat4 uP_m;
+    vec4 uCameraPosition; // w unused
+};
+
 uniform mat4 uM_m = mat4(1.0f);
-uniform mat4 uV_m = mat4(1.0f);
+uniform int uTexIndex = 0; // which resident texture, instead of binding a texture per draw
 
 out VS_OUT
 {
     vec2 texcoord;
+    flat int texture_index;
 } vs_out;
 
 void main()
@@ -18,4 +26,5 @@ void main()
     gl_Position = uP_m * uV_m * uM_m * vec4(aPos, 1.0f);
 
     vs_out.texcoord = aTex;
+    vs_out.texture_index = uTexIndex;
 }
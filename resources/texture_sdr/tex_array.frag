@@ -0,0 +1,16 @@
+#version 460 core
+in VS_OUT
+{
+    vec2 texcoord;
+    flat int texture_index; // which resident texture, from the draw or the instance
+} fs_in;
+
+uniform sampler2DArray textures; // all resident scene textures, one per layer (texture unit 0)
+
+out vec4 FragColor; // final output
+
+void main()
+{
+    // use only texture
+    FragColor = texture(textures, vec3(fs_in.texcoord, fs_in.texture_index));
+}
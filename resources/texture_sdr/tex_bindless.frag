@@ -0,0 +1,20 @@
+#version 460 core
+#extension GL_ARB_bindless_texture : require
+in VS_OUT
+{
+    vec2 texcoord;
+    flat int texture_index; // which resident texture, from the draw or the instance
+} fs_in;
+
+layout(std430, binding = 3) readonly buffer TextureHandles
+{
+    sampler2D textures[]; // handles of all resident scene textures
+};
+
+out vec4 FragColor; // final output
+
+void main()
+{
+    // use only texture
+    FragColor = texture(textures[fs_in.texture_index], fs_in.texcoord);
+}
@@ -0,0 +1,40 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNorm;
+layout (location = 2) in vec2 aTex;
+
+struct Instance
+{
+    mat4 model;
+    int texture_index;
+    int draw_index; // used by the cull pass
+};
+layout(std430, binding = 4) readonly buffer Instances
+{
+    Instance instances[]; // all instanced draws of the frame (visible ones, when culled), each starts at its base instance
+};
+
+// Written once per frame by CameraUniforms
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 uV_m;
+    mat4 uP_m;
+    vec4 uCameraPosition; // w unused
+};
+
+out VS_OUT
+{
+    vec2 texcoord;
+    flat int texture_index;
+} vs_out;
+
+void main()
+{
+    Instance instance = instances[gl_BaseInstance + gl_InstanceID];
+
+    // Outputs the positions/coordinates of all vertices
+    gl_Position = uP_m * uV_m * instance.model * vec4(aPos, 1.0f);
+
+    vs_out.texcoord = aTex;
+    vs_out.texture_index = instance.texture_index;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <fstream>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "capture/FrameSource.hpp"
+#include "capture/VideoCaptureSource.hpp"
+#include "capture/ImageDirectorySource.hpp"
+#include "capture/SyntheticSource.hpp"
+
+void FrameSource::set_pace(double fps) {
+    frame_interval = fps > 0.0
+        ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps))
+        : std::chrono::steady_clock::duration::zero();
+}
+
+bool FrameSource::read(cv::Mat& frame) {
+    if (frame_interval.count() > 0) {
+        // Keep the replay rate, but do not try to catch up after a slow consumer
+        auto now = std::chrono::steady_clock::now();
+        if (next_frame_time > now) {
+            std::this_thread::sleep_until(next_frame_time);
+            now = next_frame_time;
+        }
+        next_frame_time = now + frame_interval;
+    }
+
+    if (!grab(frame) || frame.empty()) {
+        return false;
+    }
+    n_frames_read++;
+    return true;
+}
+
+std::unique_ptr<FrameSource> FrameSource::create(const FrameSourceConfig& config) {
+    std::unique_ptr<FrameSource> source;
+    if (config.type == "camera") {
+        source = VideoCaptureSource::open_camera(config.device);
+    }
+    else if (config.type == "video") {
+        source = VideoCaptureSource::open_file(config.path, config.loop, config.max_speed);
+    }
+    else if (config.type == "images") {
+        source = ImageDirectorySource::open(config.path, config.fps, config.loop, config.max_speed);
+    }
+    else if (config.type == "synthetic") {
+        source = std::make_unique<SyntheticSource>(cv::Size(config.width, config.height), config.fps, config.max_speed);
+    }
+    else {
+        std::cerr << "Error: Unknown frame source type: " << config.type << "\n";
+        return nullptr;
+    }
+
+    if (source) {
+        std::cout << "Frame source: " << source->describe() << (config.max_speed ? ", max speed" : "") << "\n";
+    }
+    return source;
+}
+
+FrameSourceConfig FrameSource::config_from_json(const nlohmann::json& j) {
+    FrameSourceConfig config;
+    config.type = j.value("type", config.type);
+    config.device = j.value("device", config.device);
+    config.path = j.value("path", config.path);
+    config.width = j.value("width", config.width);
+    config.height = j.value("height", config.height);
+    config.fps = j.value("fps", config.fps);
+    config.loop = j.value("loop", config.loop);
+    config.max_speed = j.value("max_speed", config.max_speed);
+    return config;
+}
+
+FrameSourceConfig FrameSource::read_config(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open config file: " << filename << ", using the camera" << std::endl;
+        return FrameSourceConfig{};
+    }
+
+    try {
+        nlohmann::json j;
+        file >> j;
+        if (j.contains("source")) {
+            return config_from_json(j["source"]);
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Error parsing JSON: " << e.what() << std::endl;
+    }
+    return FrameSourceConfig{};
+}
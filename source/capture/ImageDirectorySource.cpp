@@ -0,0 +1,68 @@
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include "capture/ImageDirectorySource.hpp"
+
+ImageDirectorySource::ImageDirectorySource(std::filesystem::path directory, bool loop)
+    : directory(std::move(directory)), loop(loop) {
+}
+
+std::unique_ptr<ImageDirectorySource> ImageDirectorySource::open(const std::filesystem::path& directory, double fps, bool loop, bool max_speed) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        std::cerr << "Error: Not an image directory: " << directory << "\n";
+        return nullptr;
+    }
+
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".bmp")) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    auto source = std::unique_ptr<ImageDirectorySource>(new ImageDirectorySource(directory, loop));
+    source->set_pace(max_speed ? 0.0 : fps);
+    for (const auto& file : files) {
+        cv::Mat image = cv::imread(file.string(), cv::IMREAD_COLOR);
+        if (image.empty()) {
+            std::cerr << "Skipping unreadable image: " << file << "\n";
+            continue;
+        }
+        // The tracker uploads into fixed-size textures, every frame gets the size of the first one
+        if (!source->images.empty() && image.size() != source->images.front().size()) {
+            cv::resize(image, image, source->images.front().size(), 0.0, 0.0, cv::INTER_AREA);
+        }
+        source->images.push_back(std::move(image));
+    }
+
+    if (source->images.empty()) {
+        std::cerr << "Error: No images in " << directory << "\n";
+        return nullptr;
+    }
+    return source;
+}
+
+cv::Size ImageDirectorySource::size() const {
+    return images.front().size();
+}
+
+std::string ImageDirectorySource::describe() const {
+    return "images " + directory.string() + " (" + std::to_string(images.size()) + " frames)";
+}
+
+bool ImageDirectorySource::grab(cv::Mat& frame) {
+    if (next_image == images.size()) {
+        if (!loop) {
+            return false;
+        }
+        next_image = 0;
+    }
+    images[next_image++].copyTo(frame); // the consumer draws into its frame, the originals stay clean
+    return true;
+}
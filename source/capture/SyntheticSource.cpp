@@ -0,0 +1,40 @@
+#include <cmath>
+#include <algorithm>
+#include <numbers>
+#include <string>
+
+#include "capture/SyntheticSource.hpp"
+
+SyntheticSource::SyntheticSource(cv::Size size, double fps, bool max_speed)
+    : frame_size(size) {
+    set_pace(max_speed ? 0.0 : fps);
+    // Fixed seed: every run sees the same frames
+    background.create(frame_size, CV_8UC3);
+    cv::RNG rng(0x1C9);
+    rng.fill(background, cv::RNG::UNIFORM, cv::Scalar(40, 40, 40), cv::Scalar(120, 140, 120));
+    cv::GaussianBlur(background, background, cv::Size(9, 9), 0.0);
+}
+
+cv::Size SyntheticSource::size() const {
+    return frame_size;
+}
+
+std::string SyntheticSource::describe() const {
+    return "synthetic " + std::to_string(frame_size.width) + "x" + std::to_string(frame_size.height);
+}
+
+bool SyntheticSource::grab(cv::Mat& frame) {
+    background.copyTo(frame);
+
+    // One turn every 120 frames, something for the red tracker to follow
+    double angle = 2.0 * std::numbers::pi * static_cast<double>(n_generated % 120) / 120.0;
+    cv::Point center(
+        static_cast<int>(frame_size.width * (0.5 + 0.3 * std::cos(angle))),
+        static_cast<int>(frame_size.height * (0.5 + 0.3 * std::sin(angle)))
+    );
+    int radius = std::max(4, std::min(frame_size.width, frame_size.height) / 12);
+    cv::circle(frame, center, radius, CV_RGB(220, 20, 30), cv::FILLED, cv::LINE_AA);
+
+    n_generated++;
+    return true;
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+
+#include "capture/VideoCaptureSource.hpp"
+
+VideoCaptureSource::VideoCaptureSource(std::string name, bool loop)
+    : name(std::move(name)), loop(loop) {
+}
+
+std::unique_ptr<VideoCaptureSource> VideoCaptureSource::open_camera(int device) {
+    // The device delivers frames at its own rate, no pacing
+    auto source = std::unique_ptr<VideoCaptureSource>(new VideoCaptureSource("camera " + std::to_string(device), false));
+    if (!source->capture_device.open(device)) {
+        std::cerr << "Error: Could not open camera.\n";
+        return nullptr;
+    }
+    return source;
+}
+
+std::unique_ptr<VideoCaptureSource> VideoCaptureSource::open_file(const std::string& path, bool loop, bool max_speed) {
+    auto source = std::unique_ptr<VideoCaptureSource>(new VideoCaptureSource("video " + path, loop));
+    if (!source->capture_device.open(path)) {
+        std::cerr << "Error: Could not open video file: " << path << "\n";
+        return nullptr;
+    }
+    if (!max_speed) {
+        source->set_pace(source->capture_device.get(cv::CAP_PROP_FPS)); // 0 if the container does not say, then unpaced
+    }
+    return source;
+}
+
+cv::Size VideoCaptureSource::size() const {
+    return cv::Size(
+        static_cast<int>(capture_device.get(cv::CAP_PROP_FRAME_WIDTH)),
+        static_cast<int>(capture_device.get(cv::CAP_PROP_FRAME_HEIGHT))
+    );
+}
+
+std::string VideoCaptureSource::describe() const {
+    return name;
+}
+
+bool VideoCaptureSource::grab(cv::Mat& frame) {
+    if (capture_device.read(frame) && !frame.empty()) {
+        return true;
+    }
+    if (!loop) {
+        return false;
+    }
+    // End of the file: rewind and try once more
+    capture_device.set(cv::CAP_PROP_POS_FRAMES, 0);
+    return capture_device.read(frame) && !frame.empty();
+}
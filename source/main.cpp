@@ -2,6 +2,11 @@
 #include "include/runners/GLApp.hpp"
 #include "include/runners/TrackApp.hpp"
 #include "include/runners/ThreadTrackApp.hpp"
+#include "include/runners/HandoffBenchApp.hpp"
+#include "include/runners/RedBenchApp.hpp"
+#include "include/runners/AllocCheckApp.hpp"
+#include "include/runners/TrackBenchApp.hpp"
+#include "include/runners/TextureBakeApp.hpp"
 #include "include/scenes/ShooterScene.hpp"
 #define MINIAUDIO_IMPLEMENTATION
 #include "audio/Miniaudio.h"
@@ -30,5 +35,35 @@ int main()
         if (rasterApp.init()) rasterApp.run();
     #endif
 
+    #ifdef RUN_HANDOFFBENCH
+        HandoffBenchApp handoffBenchApp;
+        if (!handoffBenchApp.init()) return EXIT_FAILURE;
+        return handoffBenchApp.run();
+    #endif
+
+    #ifdef RUN_REDBENCH
+        RedBenchApp redBenchApp;
+        if (!redBenchApp.init()) return EXIT_FAILURE;
+        return redBenchApp.run();
+    #endif
+
+    #ifdef RUN_ALLOCCHECK
+        AllocCheckApp allocCheckApp;
+        if (!allocCheckApp.init()) return EXIT_FAILURE;
+        return allocCheckApp.run();
+    #endif
+
+    #ifdef RUN_TRACKBENCH
+        TrackBenchApp trackBenchApp;
+        if (!trackBenchApp.init()) return EXIT_FAILURE;
+        return trackBenchApp.run();
+    #endif
+
+    #ifdef RUN_TEXTUREBAKE
+        TextureBakeApp textureBakeApp;
+        if (!textureBakeApp.init()) return EXIT_FAILURE;
+        return textureBakeApp.run();
+    #endif
+
     return 0;
 }
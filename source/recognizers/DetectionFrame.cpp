@@ -0,0 +1,78 @@
+#include <cmath>
+#include <algorithm>
+
+#include <opencv2/opencv.hpp>
+
+#include "recognizers/DetectionFrame.hpp"
+
+DetectionFrame::DetectionFrame(const cv::Mat& image) {
+    reset(image);
+}
+
+void DetectionFrame::reset(const cv::Mat& image) {
+    levels[0].bgr = image; // level 0 is the source itself
+    levels[0].has_bgr = true;
+    levels[0].has_gray = levels[0].has_hsv = false;
+    for (int level = 1; level < DETECTION_MAX_LEVELS; level++) {
+        levels[level].has_bgr = levels[level].has_gray = levels[level].has_hsv = false;
+    }
+}
+
+int DetectionFrame::level_for(float scale) {
+    if (!(scale > 0.0f) || scale >= 1.0f) {
+        return 0;
+    }
+    // every level halves the resolution, never go below the requested one
+    int level = static_cast<int>(std::floor(std::log2(1.0f / scale) + 1e-4f));
+    return std::clamp(level, 0, DETECTION_MAX_LEVELS - 1);
+}
+
+void DetectionFrame::downscale(const cv::Mat& src, cv::Mat& dst) {
+    // 2x2 box average. cv::pyrDown and cv::resize allocate their row buffers on every call, this only reuses dst.
+    CV_Assert(src.type() == CV_8UC3);
+    dst.create(src.rows / 2, src.cols / 2, CV_8UC3);
+    for (int y = 0; y < dst.rows; y++) {
+        const uchar* top = src.ptr<uchar>(2 * y);
+        const uchar* bottom = src.ptr<uchar>(2 * y + 1);
+        uchar* out = dst.ptr<uchar>(y);
+        for (int x = 0; x < dst.cols * 3; x += 3) {
+            for (int c = 0; c < 3; c++) {
+                int i = 2 * x + c;
+                out[x + c] = static_cast<uchar>((top[i] + top[i + 3] + bottom[i] + bottom[i + 3] + 2) >> 2);
+            }
+        }
+    }
+}
+
+const cv::Mat& DetectionFrame::bgr(int level) {
+    level = std::clamp(level, 0, DETECTION_MAX_LEVELS - 1);
+    Level& current = levels[level];
+    std::scoped_lock lock(current.bgr_mux);
+    if (!current.has_bgr) {
+        downscale(bgr(level - 1), current.bgr); // level 0 always has it
+        current.has_bgr = true;
+    }
+    return current.bgr;
+}
+
+const cv::Mat& DetectionFrame::gray(int level) {
+    level = std::clamp(level, 0, DETECTION_MAX_LEVELS - 1);
+    Level& current = levels[level];
+    std::scoped_lock lock(current.gray_mux);
+    if (!current.has_gray) {
+        cv::cvtColor(bgr(level), current.gray, cv::COLOR_BGR2GRAY);
+        current.has_gray = true;
+    }
+    return current.gray;
+}
+
+const cv::Mat& DetectionFrame::hsv(int level) {
+    level = std::clamp(level, 0, DETECTION_MAX_LEVELS - 1);
+    Level& current = levels[level];
+    std::scoped_lock lock(current.hsv_mux);
+    if (!current.has_hsv) {
+        cv::cvtColor(bgr(level), current.hsv, cv::COLOR_BGR2HSV);
+        current.has_hsv = true;
+    }
+    return current.hsv;
+}
@@ -1,10 +1,12 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 #include <opencv2/opencv.hpp>
 
 #include "include/recognizers/FaceRecognizer.hpp"
 #include "include/render/Drawings.hpp"
+#include "include/concurrency/TaskScheduler.hpp"
 
 FaceRecognizer::FaceRecognizer() {
 	// Constructor
@@ -49,25 +51,104 @@ int FaceRecognizer::run() {
     return EXIT_SUCCESS;
 }
 
-std::vector<cv::Point2f> FaceRecognizer::find_face(cv::Mat& frame) {
-    cv::Point2f center(0.0f, 0.0f); 
-
-    cv::Mat scene_grey;
-    cv::cvtColor(frame, scene_grey, cv::COLOR_BGR2GRAY);
-
-    std::vector<cv::Rect> faces;
-    std::vector<cv::Point2f> centers;
-    classifier.detectMultiScale(scene_grey, faces);
-    if (faces.size() > 0) {
-        for (auto face : faces) {
-            auto x_cord = (face.x + face.width / 2.0f) / frame.cols;
-            auto y_cord = (face.y + face.height / 2.0f) / frame.rows;
-            cv::Point2f center(x_cord, y_cord);
-            centers.push_back(center);
+void FaceRecognizer::set_tracking(bool enabled, int full_scan_interval) {
+    tracking_on = enabled;
+    this->full_scan_interval = std::max(full_scan_interval, 1);
+    tracked_faces.clear();
+}
+
+void FaceRecognizer::set_working_scale(float scale) {
+    working_level = DetectionFrame::level_for(scale);
+    tracked_faces.clear(); // kept in the pixels of the old level
+}
+
+void FaceRecognizer::scan_full(const cv::Mat& scene_grey, FaceWorkspace& workspace) {
+    classifier.detectMultiScale(scene_grey, workspace.faces);
+}
+
+bool FaceRecognizer::scan_tracked(const cv::Mat& scene_grey, FaceWorkspace& workspace) {
+    // Search a padded window around every tracked face, only at scales close to its last size.
+    // Returns false when any tracked face was not found again.
+    const cv::Rect frame_rect(0, 0, scene_grey.cols, scene_grey.rows);
+    auto& faces = workspace.faces;
+    auto& found = workspace.found;
+    faces.clear();
+
+    for (const auto& tracked : tracked_faces) {
+        int pad_x = static_cast<int>(tracked.width * FACE_ROI_PADDING);
+        int pad_y = static_cast<int>(tracked.height * FACE_ROI_PADDING);
+        cv::Rect roi = cv::Rect(tracked.x - pad_x, tracked.y - pad_y, tracked.width + 2 * pad_x, tracked.height + 2 * pad_y) & frame_rect;
+        if (roi.empty()) {
+            return false;
         }
+
+        cv::Size min_size(static_cast<int>(tracked.width / FACE_ROI_SCALE_STEP), static_cast<int>(tracked.height / FACE_ROI_SCALE_STEP));
+        cv::Size max_size(static_cast<int>(tracked.width * FACE_ROI_SCALE_STEP), static_cast<int>(tracked.height * FACE_ROI_SCALE_STEP));
+
+        classifier.detectMultiScale(scene_grey(roi), found, 1.1, 3, 0, min_size, max_size);
+        if (found.empty()) {
+            return false;
+        }
+
+        // Windows of faces close to each other overlap, keep only one detection per face
+        for (auto face : found) {
+            face += roi.tl();
+            cv::Point center(face.x + face.width / 2, face.y + face.height / 2);
+            bool duplicate = std::any_of(faces.begin(), faces.end(), [&center](const cv::Rect& known) { return known.contains(center); });
+            if (!duplicate) {
+                faces.push_back(face);
+            }
+        }
+    }
+
+    return true;
+}
+
+std::vector<cv::Point2f> FaceRecognizer::find_face(cv::Mat& frame) {
+    DetectionFrame detection_frame(frame);
+    FaceWorkspace workspace;
+    FaceCenters centers;
+    find_face(detection_frame, workspace, centers);
+    return std::vector<cv::Point2f>(centers.begin(), centers.end());
+}
+
+void FaceRecognizer::find_face(DetectionFrame& frame, FaceWorkspace& workspace, FaceCenters& centers) {
+    // Detection runs on the working level of the pyramid, results are normalized so the level does not show
+    const cv::Mat& scene_grey = frame.gray(working_level);
+    centers.clear();
+
+    last_full_scan = true;
+    if (tracking_on && !tracked_faces.empty() && frames_since_full_scan < full_scan_interval) {
+        last_full_scan = !scan_tracked(scene_grey, workspace);
+    }
+    if (last_full_scan) {
+        // not tracking, lost a face or time to look for new ones
+        scan_full(scene_grey, workspace);
+        frames_since_full_scan = 0;
+    }
+    frames_since_full_scan++;
+
+    std::size_t n_dropped = 0;
+    for (auto face : workspace.faces) {
+        auto x_cord = (face.x + face.width / 2.0f) / scene_grey.cols;
+        auto y_cord = (face.y + face.height / 2.0f) / scene_grey.rows;
+        if (!centers.push_back(cv::Point2f(x_cord, y_cord)))
+            n_dropped++;
     }
+    if (n_dropped > 0 && n_dropped_faces.fetch_add(n_dropped, std::memory_order_relaxed) == 0) {
+        // first time only, the total is in dropped_faces()
+        std::cerr << "Face detector found " << workspace.faces.size() << " faces, only " << FACE_MAX_FACES << " are reported\n";
+    }
+
+    // The detections become the tracked faces, the old buffer is reused for the next frame
+    std::swap(tracked_faces, workspace.faces);
+}
 
-    return centers;
+std::future<std::vector<cv::Point2f>> FaceRecognizer::find_face_async(const cv::Mat& frame) {
+    // The frame header is copied, the pixels are shared: keep them unchanged until the result is ready
+    return TaskScheduler::global().submit([this, frame]() mutable {
+        return find_face(frame);
+    });
 }
 
 FaceRecognizer::~FaceRecognizer()
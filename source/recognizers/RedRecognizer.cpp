@@ -1,12 +1,17 @@
 #include <vector>
 #include <numeric>
-#include <chrono>
 #include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <array>
+#include <algorithm>
 
 #include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 
 #include "recognizers/RedRecognizer.hpp"
 #include "render/Drawings.hpp"
+#include "concurrency/TaskScheduler.hpp"
 
 RedRecognizer::RedRecognizer() {
     // Constructor
@@ -84,19 +89,201 @@ int RedRecognizer::run_video(std::string path) {
     
 }
 
+void RedRecognizer::set_working_scale(float scale) {
+    working_level = DetectionFrame::level_for(scale);
+}
+
 cv::Point2f RedRecognizer::find_red(cv::Mat& frame) {
-    auto start = std::chrono::steady_clock::now();
+    DetectionFrame detection_frame(frame);
+    return find_red(detection_frame);
+}
+
+namespace {
+    // OpenCV's own fixed-point tables for 8-bit BGR -> HSV, so the fused kernel classifies exactly like cvtColor + inRange
+    constexpr int hsv_shift = 12;
+
+    typedef struct HsvTables {
+        std::array<int, 256> sdiv; // saturation = (diff * sdiv[value]) >> hsv_shift, rounded
+        std::array<int, 256> hdiv; // hue = ((g - b) * hdiv[diff]) >> hsv_shift, rounded, in the red sector
+    } HsvTables;
+
+    const HsvTables& hsv_tables() {
+        static const HsvTables tables = []() {
+            HsvTables tables{};
+            for (int i = 1; i < 256; i++) {
+                tables.sdiv[i] = cvRound((255 << hsv_shift) / (1.0 * i));
+                tables.hdiv[i] = cvRound((180 << hsv_shift) / (6.0 * i));
+            }
+            return tables;
+        }();
+        return tables;
+    }
+
+    // Thresholds on the products before the rounding shift
+    constexpr int saturation_min_product = (RED_MIN_SATURATION << hsv_shift) - (1 << (hsv_shift - 1));
+    constexpr int hue_max_product = ((RED_MAX_HUE + 1) << hsv_shift) - (1 << (hsv_shift - 1)); // exclusive
+    constexpr int hue_min_product = -(RED_MAX_HUE << hsv_shift) - (1 << (hsv_shift - 1));
+
+    inline bool is_red(int b, int g, int r, const HsvTables& tables) {
+        // Red hues only come out of the sector where red is the (first) maximum
+        int value = std::max(std::max(b, g), r);
+        if (value != r || value < RED_MIN_VALUE) {
+            return false;
+        }
+        int diff = value - std::min(std::min(b, g), r);
+        if (diff * tables.sdiv[value] < saturation_min_product) {
+            return false;
+        }
+        int hue = (g - b) * tables.hdiv[diff];
+        return hue >= hue_min_product && hue < hue_max_product;
+    }
+
+    typedef struct RedSums {
+        std::uint64_t count = 0, sum_x = 0, sum_y = 0;
+    } RedSums;
+
+    // One pass over BGR rows: classify and accumulate, nothing is written anywhere
+    RedSums sum_red_rows(const cv::Mat& frame, int row_begin, int row_end) {
+        const HsvTables& tables = hsv_tables();
+        RedSums sums;
+
+#if CV_SIMD
+        using namespace cv;
+        const int n8 = v_uint8::nlanes;
+        const int n32 = v_int32::nlanes;
+        int iota_values[v_int32::nlanes];
+        for (int i = 0; i < n32; i++) {
+            iota_values[i] = i;
+        }
+        const v_int32 iota = vx_load(iota_values);
+        const v_uint8 min_value = vx_setall_u8(RED_MIN_VALUE);
+        const v_int32 s_min = vx_setall_s32(saturation_min_product);
+        const v_int32 h_min = vx_setall_s32(hue_min_product);
+        const v_int32 h_max = vx_setall_s32(hue_max_product);
+
+        // u8 lanes -> 4 vectors of s32 lanes
+        auto expand4 = [](const v_uint8& x, v_int32 out[4]) {
+            v_uint16 lo, hi;
+            v_expand(x, lo, hi);
+            v_uint32 a, b, c, d;
+            v_expand(lo, a, b);
+            v_expand(hi, c, d);
+            out[0] = v_reinterpret_as_s32(a);
+            out[1] = v_reinterpret_as_s32(b);
+            out[2] = v_reinterpret_as_s32(c);
+            out[3] = v_reinterpret_as_s32(d);
+        };
+        // 0 / -1 mask lanes stay 0 / -1
+        auto expand4_mask = [](const v_uint8& mask, v_int32 out[4]) {
+            v_int16 lo, hi;
+            v_expand(v_reinterpret_as_s8(mask), lo, hi);
+            v_expand(lo, out[0], out[1]);
+            v_expand(hi, out[2], out[3]);
+        };
+#endif
+
+        for (int y = row_begin; y < row_end; y++) {
+            const uchar* row = frame.ptr<uchar>(y);
+            int x = 0;
+            std::uint64_t row_count = 0, row_x = 0;
+
+#if CV_SIMD
+            v_int32 count_acc = vx_setzero_s32(), x_acc = vx_setzero_s32();
+            for (; x <= frame.cols - n8; x += n8) {
+                v_uint8 b, g, r;
+                v_load_deinterleave(row + 3 * x, b, g, r);
+                v_uint8 value = v_max(v_max(b, g), r);
+                v_uint8 candidates = (r == value) & (value >= min_value);
+                if (!v_check_any(candidates)) {
+                    continue; // most blocks of a camera frame end here
+                }
+                v_uint8 diff = value - v_min(v_min(b, g), r);
+
+                v_int32 mask32[4], value32[4], diff32[4], g32[4], b32[4];
+                expand4_mask(candidates, mask32);
+                expand4(value, value32);
+                expand4(diff, diff32);
+                expand4(g, g32);
+                expand4(b, b32);
+                for (int k = 0; k < 4; k++) {
+                    v_int32 saturation = diff32[k] * v_lut(tables.sdiv.data(), value32[k]);
+                    v_int32 hue = (g32[k] - b32[k]) * v_lut(tables.hdiv.data(), diff32[k]);
+                    v_int32 red = mask32[k] & (saturation >= s_min) & (hue >= h_min) & (hue < h_max);
+                    count_acc -= red; // red lanes are -1
+                    x_acc += (vx_setall_s32(x + k * n32) + iota) & red;
+                }
+            }
+            row_count += static_cast<std::uint64_t>(v_reduce_sum(count_acc));
+            row_x += static_cast<std::uint64_t>(v_reduce_sum(x_acc));
+#endif
+
+            // Scalar fallback and the rest of the row
+            for (; x < frame.cols; x++) {
+                const uchar* pixel = row + 3 * x;
+                if (is_red(pixel[0], pixel[1], pixel[2], tables)) {
+                    row_count++;
+                    row_x += x;
+                }
+            }
+
+            sums.count += row_count;
+            sums.sum_x += row_x;
+            sums.sum_y += row_count * y;
+        }
+
+        return sums;
+    }
+
+    cv::Point2f normalized_centroid(std::uint64_t count, std::uint64_t sum_x, std::uint64_t sum_y, const cv::Size& size) {
+        // If no red pixels are found, return the default (0.0f, 0.0f)
+        if (count == 0) {
+            return cv::Point2f(0.0f, 0.0f);
+        }
+
+        // Calculate Centroid
+        cv::Point2f centroid_absolute( // Gets centroid
+            static_cast<float>(static_cast<double>(sum_x) / count),
+            static_cast<float>(static_cast<double>(sum_y) / count)
+        );
+
+        return cv::Point2f{ // Normalize
+            centroid_absolute.x / size.width,
+            centroid_absolute.y / size.height
+        };
+    }
+}
+
+cv::Point2f RedRecognizer::find_red(DetectionFrame& frame) {
+    // Classified on the working level of the pyramid, the centroid is normalized so the level does not show
+    const cv::Mat& image = frame.bgr(working_level);
+    CV_Assert(image.type() == CV_8UC3);
+
+    // Integer sums, merged from all stripes
+    std::atomic<std::uint64_t> count{ 0 }, sum_x{ 0 }, sum_y{ 0 };
+
+    // Every stripe of rows is classified on its own, on the shared task scheduler
+    TaskScheduler::global().parallel_for(0, image.rows, RED_STRIPE_ROWS, [&](std::size_t row_begin, std::size_t row_end) {
+        RedSums stripe = sum_red_rows(image, (int)row_begin, (int)row_end);
+        count += stripe.count;
+        sum_x += stripe.sum_x;
+        sum_y += stripe.sum_y;
+    });
+
+    return normalized_centroid(count, sum_x, sum_y, image.size());
+}
+
+cv::Point2f RedRecognizer::find_red_reference(const cv::Mat& frame) {
+    // Prepare red hue ranges
+    const cv::Scalar lower_red1 = cv::Scalar(0, RED_MIN_SATURATION, RED_MIN_VALUE); // Hue, Saturation, Value (Brightness)
+    const cv::Scalar upper_red1 = cv::Scalar(RED_MAX_HUE, 255, 255);
+    const cv::Scalar lower_red2 = cv::Scalar(180 - RED_MAX_HUE, RED_MIN_SATURATION, RED_MIN_VALUE);
+    const cv::Scalar upper_red2 = cv::Scalar(180, 255, 255);
+
     cv::Mat img_HSV, mask_low_red, mask_high_red, mask_combined;
 
     // Convert image to HSV
     cv::cvtColor(frame, img_HSV, cv::COLOR_BGR2HSV);
 
-    // Prepare red hue ranges
-    cv::Scalar lower_red1 = cv::Scalar(0, 150, 150); // Hue, Saturation, Value (Brightness)
-    cv::Scalar upper_red1 = cv::Scalar(20, 255, 255);
-    cv::Scalar lower_red2 = cv::Scalar(160, 150, 150);
-    cv::Scalar upper_red2 = cv::Scalar(180, 255, 255);
-
     // Checks within range
     cv::inRange(img_HSV, lower_red1, upper_red1, mask_low_red);
     cv::inRange(img_HSV, lower_red2, upper_red2, mask_high_red);
@@ -104,29 +291,15 @@ cv::Point2f RedRecognizer::find_red(cv::Mat& frame) {
     // Combines masks
     cv::bitwise_or(mask_low_red, mask_high_red, mask_combined);
 
-    // Morphological Operations for noise reduction (TODO)
-
     // Finds masked pixels
     std::vector<cv::Point> white_pixels;
     cv::findNonZero(mask_combined, white_pixels);
 
-    // If no red pixels are found, return the default (0.0f, 0.0f)
-    if (white_pixels.size() == 0) {
-        return cv::Point2f(0.0f, 0.0f);
+    std::uint64_t sum_x = 0, sum_y = 0;
+    for (const auto& pixel : white_pixels) {
+        sum_x += pixel.x;
+        sum_y += pixel.y;
     }
 
-    // Calculate Centroid
-    cv::Point2f white_accum = std::reduce(white_pixels.begin(), white_pixels.end()); // Sums x and y coords
-
-    cv::Point2f centroid_absolute = white_accum / (float)white_pixels.size(); // Gets centroid
-
-    cv::Point2f centroid_normalized = { // Normalize
-        centroid_absolute.x / frame.cols,
-        centroid_absolute.y / frame.rows
-    };
-    auto end = std::chrono::steady_clock::now();
-    std::chrono::duration<double> elapsed_seconds = end - start;
-    std::cout << "Elapsed time: " << elapsed_seconds.count()*1000 << " millisec" << std::endl;
-
-    return centroid_normalized;
+    return normalized_centroid(white_pixels.size(), sum_x, sum_y, frame.size());
 }
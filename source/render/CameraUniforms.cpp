@@ -0,0 +1,20 @@
+#include "render/CameraUniforms.hpp"
+
+CameraUniforms::CameraUniforms() {
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, sizeof(CameraData), nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+CameraUniforms::~CameraUniforms() {
+    glDeleteBuffers(1, &buffer);
+}
+
+void CameraUniforms::update(const glm::mat4& view_matrix, const glm::mat4& projection_matrix, const glm::vec3& camera_position) {
+    CameraData data{ view_matrix, projection_matrix, glm::vec4(camera_position, 1.0f) };
+    glNamedBufferSubData(buffer, 0, sizeof(CameraData), &data);
+    bind();
+}
+
+void CameraUniforms::bind() const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UNIFORMS_BINDING, buffer);
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "render/FrustumCuller.hpp"
+
+FrustumCuller::FrustumCuller() {
+    if (!GLEW_VERSION_4_3 && !GLEW_ARB_compute_shader) {
+        std::cerr << "No compute shaders, frustum culling runs on the CPU" << std::endl;
+        return;
+    }
+    try {
+        cull_shader = std::make_unique<ShaderProgram>(std::filesystem::path("resources/cull_sdr/frustum_cull.comp"));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Frustum cull shader unavailable (" << e.what() << "), culling runs on the CPU" << std::endl;
+        return;
+    }
+
+    glCreateBuffers(1, &counter_buffer);
+    glNamedBufferStorage(counter_buffer, sizeof(GLuint), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &readback_buffer);
+    glNamedBufferStorage(readback_buffer, FRUSTUM_CULL_READBACKS * sizeof(GLuint), nullptr, flags);
+    readback = static_cast<const GLuint*>(glMapNamedBufferRange(readback_buffer, 0, FRUSTUM_CULL_READBACKS * sizeof(GLuint), flags));
+}
+
+FrustumCuller::~FrustumCuller() {
+    for (auto fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if (readback) {
+        glUnmapNamedBuffer(readback_buffer);
+    }
+    glDeleteBuffers(1, &readback_buffer);
+    glDeleteBuffers(1, &counter_buffer);
+}
+
+bool FrustumCuller::gpu_available() const {
+    return cull_shader != nullptr;
+}
+
+void FrustumCuller::cull(GLsizei n_instances, std::size_t n_cullable, const glm::mat4& view_projection) {
+    glClearNamedBufferData(counter_buffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_COUNTERS_BINDING, counter_buffer);
+
+    cull_shader->use();
+    cull_shader->set_uniform(instance_count_id, static_cast<GLint>(n_instances));
+    cull_shader->set_uniform(view_projection_id, view_projection);
+    glDispatchCompute((n_instances + 63) / 64, 1, 1);
+    // the draws read the commands as indirect parameters and the instances as storage, the copy below reads the counter
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    if (n_issued - n_read >= FRUSTUM_CULL_READBACKS) {
+        return; // the GPU is that far behind, skip counting this pass rather than stall
+    }
+    std::size_t slot = n_issued % FRUSTUM_CULL_READBACKS;
+    glCopyNamedBufferSubData(counter_buffer, readback_buffer, 0, slot * sizeof(GLuint), sizeof(GLuint));
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    cullable[slot] = n_cullable;
+    n_issued++;
+}
+
+std::optional<CullStats> FrustumCuller::poll() {
+    std::optional<CullStats> stats;
+    while (n_read < n_issued) {
+        std::size_t slot = n_read % FRUSTUM_CULL_READBACKS;
+        GLenum status = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+            break;
+        }
+        glDeleteSync(fences[slot]);
+        fences[slot] = nullptr;
+
+        std::size_t visible = readback[slot];
+        stats = CullStats{ visible, cullable[slot] - visible };
+        n_read++;
+    }
+    return stats;
+}
+
+bool FrustumCuller::is_visible(const glm::mat4& model_view_projection, const AABB& bounds) {
+    int outside[6] = {};
+    for (int c = 0; c < 8; c++) {
+        glm::vec3 corner((c & 1) ? bounds.max.x : bounds.min.x,
+                         (c & 2) ? bounds.max.y : bounds.min.y,
+                         (c & 4) ? bounds.max.z : bounds.min.z);
+        glm::vec4 p = model_view_projection * glm::vec4(corner, 1.0f);
+        outside[0] += p.x < -p.w;
+        outside[1] += p.x > p.w;
+        outside[2] += p.y < -p.w;
+        outside[3] += p.y > p.w;
+        outside[4] += p.z < -p.w;
+        outside[5] += p.z > p.w;
+    }
+    for (int count : outside) {
+        if (count == 8) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+
+#include "render/GeometryBuffer.hpp"
+#include "render/GlState.hpp"
+#include "assets/Mesh.hpp"
+
+GeometryBuffer::GeometryBuffer(GLsizei max_vertices, GLsizei max_indices) :
+    max_vertices(max_vertices),
+    max_indices(max_indices),
+    index_offset(static_cast<GLintptr>(max_vertices) * sizeof(Vertex)) // a multiple of sizeof(GLuint), so first_index can count from 0
+{
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, index_offset + static_cast<GLsizeiptr>(max_indices) * sizeof(GLuint), nullptr, 0); // only copied into
+
+    // Same attribute layout as every Mesh
+    glCreateVertexArrays(1, &vao);
+    glVertexArrayAttribFormat(vao, Mesh::attribute_location_position, glm::vec3::length(), GL_FLOAT, GL_FALSE, offsetof(Vertex, position));
+    glVertexArrayAttribBinding(vao, Mesh::attribute_location_position, 0);
+    glEnableVertexArrayAttrib(vao, Mesh::attribute_location_position);
+
+    glVertexArrayAttribFormat(vao, Mesh::attribute_location_normal, glm::vec3::length(), GL_FLOAT, GL_FALSE, offsetof(Vertex, normal));
+    glVertexArrayAttribBinding(vao, Mesh::attribute_location_normal, 0);
+    glEnableVertexArrayAttrib(vao, Mesh::attribute_location_normal);
+
+    glVertexArrayAttribFormat(vao, Mesh::attribute_location_texture_coords, glm::vec2::length(), GL_FLOAT, GL_FALSE, offsetof(Vertex, tex_coords));
+    glVertexArrayAttribBinding(vao, Mesh::attribute_location_texture_coords, 0);
+    glEnableVertexArrayAttrib(vao, Mesh::attribute_location_texture_coords);
+
+    glVertexArrayVertexBuffer(vao, 0, buffer, 0, sizeof(Vertex));
+    glVertexArrayElementBuffer(vao, buffer);
+}
+
+GeometryBuffer::~GeometryBuffer() {
+    glDeleteVertexArrays(1, &vao);
+    GlState::vertex_array_deleted(vao);
+    glDeleteBuffers(1, &buffer);
+}
+
+std::optional<GeometryRange> GeometryBuffer::allocate(GLuint vertex_buffer, GLsizei n_vertices, GLuint index_buffer, GLsizei n_indices) {
+    if (n_vertices > max_vertices - this->n_vertices || n_indices > max_indices - this->n_indices) {
+        std::cerr << "Geometry buffer full, " << n_vertices << " vertices and " << n_indices << " indices do not fit" << std::endl;
+        return std::nullopt;
+    }
+
+    GeometryRange range{
+        static_cast<GLuint>(index_offset / sizeof(GLuint)) + static_cast<GLuint>(this->n_indices),
+        n_indices,
+        this->n_vertices
+    };
+    glCopyNamedBufferSubData(vertex_buffer, buffer, 0, static_cast<GLintptr>(this->n_vertices) * sizeof(Vertex), static_cast<GLsizeiptr>(n_vertices) * sizeof(Vertex));
+    glCopyNamedBufferSubData(index_buffer, buffer, 0, static_cast<GLintptr>(range.first_index) * sizeof(GLuint), static_cast<GLsizeiptr>(n_indices) * sizeof(GLuint));
+
+    this->n_vertices += n_vertices;
+    this->n_indices += n_indices;
+    return range;
+}
+
+GLuint GeometryBuffer::get_vao() const {
+    return vao;
+}
@@ -0,0 +1,88 @@
+#include <array>
+
+#include "render/GlState.hpp"
+
+namespace {
+    constexpr GLuint unknown = ~0u; // no GL name is this, so the next bind always goes through
+
+    typedef struct State {
+        GLuint program = unknown;
+        GLuint vertex_array = unknown;
+        std::array<GLuint, GL_STATE_TEXTURE_UNITS> textures;
+        GlState::Counters counters;
+
+        State() { textures.fill(unknown); }
+    } State;
+
+    thread_local State state;
+}
+
+void GlState::use_program(GLuint program) {
+    state.counters.binds++;
+    if (state.program == program) {
+        return;
+    }
+    glUseProgram(program);
+    state.program = program;
+    state.counters.state_changes++;
+}
+
+void GlState::bind_vertex_array(GLuint vertex_array) {
+    state.counters.binds++;
+    if (state.vertex_array == vertex_array) {
+        return;
+    }
+    glBindVertexArray(vertex_array);
+    state.vertex_array = vertex_array;
+    state.counters.state_changes++;
+}
+
+void GlState::bind_texture_unit(GLuint unit, GLuint texture) {
+    state.counters.binds++;
+    if (unit < GL_STATE_TEXTURE_UNITS) {
+        if (state.textures[unit] == texture) {
+            return;
+        }
+        state.textures[unit] = texture;
+    }
+    glBindTextureUnit(unit, texture);
+    state.counters.state_changes++;
+}
+
+void GlState::count_draw() {
+    state.counters.draws++;
+}
+
+void GlState::program_deleted(GLuint program) {
+    if (state.program == program) {
+        state.program = unknown;
+    }
+}
+
+void GlState::vertex_array_deleted(GLuint vertex_array) {
+    if (state.vertex_array == vertex_array) {
+        state.vertex_array = unknown;
+    }
+}
+
+void GlState::texture_deleted(GLuint texture) {
+    for (auto& bound : state.textures) {
+        if (bound == texture) {
+            bound = unknown;
+        }
+    }
+}
+
+void GlState::invalidate() {
+    state.program = unknown;
+    state.vertex_array = unknown;
+    state.textures.fill(unknown);
+}
+
+void GlState::reset_counters() {
+    state.counters = Counters{};
+}
+
+GlState::Counters GlState::counters() {
+    return state.counters;
+}
@@ -0,0 +1,42 @@
+#include "render/GpuTimer.hpp"
+
+GpuTimer::GpuTimer() {
+    glCreateQueries(GL_TIME_ELAPSED, GPU_TIMER_QUERIES, queries.data());
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(GPU_TIMER_QUERIES, queries.data());
+}
+
+void GpuTimer::begin() {
+    if (n_issued - n_read >= GPU_TIMER_QUERIES) {
+        return; // the GPU is that far behind, drop this measurement rather than stall
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries[n_issued % GPU_TIMER_QUERIES]);
+    running = true;
+}
+
+void GpuTimer::end() {
+    if (!running) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    running = false;
+    n_issued++;
+}
+
+std::optional<double> GpuTimer::poll_ms() {
+    if (n_read == n_issued) {
+        return std::nullopt;
+    }
+    GLuint query = queries[n_read % GPU_TIMER_QUERIES];
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return std::nullopt;
+    }
+    GLuint64 elapsed_ns = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+    n_read++;
+    return elapsed_ns / 1e6;
+}
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <iostream>
+
+#include "render/InstanceBatcher.hpp"
+
+InstanceBatcher::InstanceBatcher() {
+    glCreateBuffers(1, &buffer);
+    glCreateBuffers(1, &culled_buffer);
+    glCreateBuffers(1, &indirect_buffer);
+    glCreateBuffers(1, &bounds_buffer);
+    if (!culler.gpu_available()) {
+        culling = Culling::cpu;
+    }
+}
+
+InstanceBatcher::~InstanceBatcher() {
+    glDeleteBuffers(1, &bounds_buffer);
+    glDeleteBuffers(1, &indirect_buffer);
+    glDeleteBuffers(1, &culled_buffer);
+    glDeleteBuffers(1, &buffer);
+}
+
+void InstanceBatcher::set_instanced_shader(const ShaderProgram* shader, std::shared_ptr<ShaderProgram> instanced_shader) {
+    instanced_shaders[shader] = std::move(instanced_shader);
+}
+
+void InstanceBatcher::set_culling(Culling culling) {
+    if (culling == Culling::gpu && !culler.gpu_available()) {
+        culling = Culling::cpu;
+    }
+    this->culling = culling;
+    cull_stats = CullStats{};
+}
+
+InstanceBatcher::Culling InstanceBatcher::get_culling() const {
+    return culling;
+}
+
+CullStats InstanceBatcher::get_cull_stats() const {
+    return cull_stats;
+}
+
+void InstanceBatcher::begin() {
+    for (auto& group : groups) {
+        group.instances.clear();
+    }
+}
+
+void InstanceBatcher::add(const Model& model, const glm::mat4& model_matrix) {
+    for (const auto& mesh_pkg : model.meshes) {
+        GroupKey key{ mesh_pkg.mesh.get(), mesh_pkg.shader.get(), mesh_pkg.texture.get() };
+        auto [found, added] = group_index.try_emplace(key, groups.size());
+        if (added) {
+            groups.push_back(Group{ key, {} });
+        }
+        groups[found->second].instances.push_back(InstanceData{ mesh_pkg.mesh_matrix * model_matrix, mesh_pkg.texture_index, -1, {} });
+    }
+}
+
+void InstanceBatcher::draw(RenderQueue& queue, const glm::mat4& view_projection) {
+    n_draws = 0;
+    n_instances = 0;
+    for (auto& multi_draw : multi_draws) {
+        multi_draw.commands.clear();
+        multi_draw.bounds.clear();
+    }
+
+    // Route the groups: meshes in a geometry buffer with nothing to bind become indirect commands
+    routes.assign(groups.size(), Route{ nullptr, nullptr, -1, 0 });
+    for (std::size_t i = 0; i < groups.size(); i++) {
+        const Group& group = groups[i];
+        if (group.instances.empty()) {
+            continue;
+        }
+        auto shader = instanced_shaders.find(group.key.shader);
+        if (shader == instanced_shaders.end()) {
+            std::cerr << "No instanced variant of shader " << group.key.shader->get_ID() << ", skipping its instances" << std::endl;
+            continue;
+        }
+        Route& route = routes[i];
+        route.shader = shader->second.get();
+        route.texture = group.instances.front().texture_index < 0 ? group.key.texture : nullptr; // resident ones are not bound
+
+        const auto& range = group.key.mesh->get_geometry_range();
+        if (range && !route.texture) {
+            route.multi_draw = multi_draw_for(route.shader, *group.key.mesh);
+            MultiDraw& multi_draw = multi_draws[route.multi_draw];
+            route.command = multi_draw.commands.size();
+            multi_draw.commands.push_back(DrawElementsIndirectCommand{ static_cast<GLuint>(range->index_count), 0, range->first_index, range->base_vertex, 0 });
+            const AABB& bounds = group.key.mesh->get_local_AABB();
+            multi_draw.bounds.push_back(CullBounds{ glm::vec4(bounds.min, 1.0f), glm::vec4(bounds.max, 1.0f) });
+        }
+    }
+
+    // Commands of all multi-draws go into one buffer, each multi-draw reads its own run of them
+    std::size_t n_commands = 0;
+    for (auto& multi_draw : multi_draws) {
+        multi_draw.first_command = n_commands;
+        n_commands += multi_draw.commands.size();
+    }
+
+    // One upload of the instances for the whole frame; the CPU culls here, the GPU later from the full set
+    staging.clear();
+    std::size_t n_cullable = 0;
+    std::size_t n_visible = 0;
+    for (std::size_t i = 0; i < groups.size(); i++) {
+        const Route& route = routes[i];
+        if (!route.shader) {
+            continue;
+        }
+        const Group& group = groups[i];
+        GLuint base_instance = static_cast<GLuint>(staging.size());
+        n_instances += group.instances.size();
+
+        if (route.multi_draw < 0) {
+            staging.insert(staging.end(), group.instances.begin(), group.instances.end());
+            queue.submit_instanced(route.shader, route.texture, group.key.mesh, static_cast<GLsizei>(group.instances.size()), base_instance);
+            n_draws++;
+            continue;
+        }
+
+        DrawElementsIndirectCommand& command = multi_draws[route.multi_draw].commands[route.command];
+        command.base_instance = base_instance;
+        n_cullable += group.instances.size();
+        if (culling == Culling::gpu) {
+            GLint draw_index = static_cast<GLint>(multi_draws[route.multi_draw].first_command + route.command);
+            for (const auto& instance : group.instances) {
+                staging.push_back(instance);
+                staging.back().draw_index = draw_index;
+            }
+            continue; // the pass counts the instances into the command
+        }
+        for (const auto& instance : group.instances) {
+            if (culling == Culling::off || FrustumCuller::is_visible(view_projection * instance.model, group.key.mesh->get_local_AABB())) {
+                staging.push_back(instance);
+            }
+        }
+        command.instance_count = static_cast<GLuint>(staging.size() - base_instance);
+        n_visible += command.instance_count;
+    }
+    if (culling != Culling::gpu) {
+        cull_stats = CullStats{ n_visible, n_cullable - n_visible };
+    }
+    else if (auto stats = culler.poll()) {
+        cull_stats = *stats;
+    }
+    if (staging.empty()) {
+        return;
+    }
+
+    // Orphaned every frame: the driver hands out fresh memory while the GPU still reads the last frame's
+    if (staging.size() > buffer_capacity) {
+        buffer_capacity = staging.size();
+        glNamedBufferData(culled_buffer, buffer_capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+    }
+    glNamedBufferData(buffer, buffer_capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+    glNamedBufferSubData(buffer, 0, staging.size() * sizeof(InstanceData), staging.data());
+
+    if (n_commands > 0) {
+        indirect_staging.clear();
+        bounds_staging.clear();
+        for (const auto& multi_draw : multi_draws) {
+            indirect_staging.insert(indirect_staging.end(), multi_draw.commands.begin(), multi_draw.commands.end());
+            bounds_staging.insert(bounds_staging.end(), multi_draw.bounds.begin(), multi_draw.bounds.end());
+        }
+        indirect_capacity = std::max(indirect_capacity, n_commands);
+        glNamedBufferData(indirect_buffer, indirect_capacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+        glNamedBufferSubData(indirect_buffer, 0, n_commands * sizeof(DrawElementsIndirectCommand), indirect_staging.data());
+    }
+
+    if (culling == Culling::gpu && n_commands > 0) {
+        glNamedBufferData(bounds_buffer, indirect_capacity * sizeof(CullBounds), nullptr, GL_STREAM_DRAW);
+        glNamedBufferSubData(bounds_buffer, 0, n_commands * sizeof(CullBounds), bounds_staging.data());
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_INPUT_BINDING, buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_DATA_BINDING, culled_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_COMMANDS_BINDING, indirect_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_BOUNDS_BINDING, bounds_buffer);
+        culler.cull(static_cast<GLsizei>(staging.size()), n_cullable, view_projection);
+    }
+    else {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_DATA_BINDING, buffer);
+    }
+
+    GLintptr offset = 0;
+    for (const auto& multi_draw : multi_draws) {
+        if (multi_draw.commands.empty()) {
+            continue;
+        }
+        GLsizei draw_count = static_cast<GLsizei>(multi_draw.commands.size());
+        queue.submit_multi_draw(multi_draw.shader, nullptr, multi_draw.vertex_array, multi_draw.primitive_type, indirect_buffer, offset, draw_count);
+        offset += draw_count * sizeof(DrawElementsIndirectCommand);
+        n_draws++;
+    }
+}
+
+int InstanceBatcher::multi_draw_for(ShaderProgram* shader, const Mesh& mesh) {
+    for (std::size_t m = 0; m < multi_draws.size(); m++) {
+        const MultiDraw& multi_draw = multi_draws[m];
+        if (multi_draw.shader == shader && multi_draw.vertex_array == mesh.get_vao() && multi_draw.primitive_type == mesh.get_primitive_type()) {
+            return static_cast<int>(m);
+        }
+    }
+    multi_draws.push_back(MultiDraw{ shader, mesh.get_vao(), mesh.get_primitive_type(), {}, {}, 0 });
+    return static_cast<int>(multi_draws.size() - 1);
+}
+
+std::size_t InstanceBatcher::get_instance_count() const {
+    return n_instances;
+}
+
+std::size_t InstanceBatcher::get_draw_count() const {
+    return n_draws;
+}
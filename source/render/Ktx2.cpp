@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "render/Ktx2.hpp"
+
+namespace {
+    const std::array<std::uint8_t, 12> identifier{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    // Vulkan formats written into the header
+    constexpr std::uint32_t vk_format_bc7_unorm = 145;
+    constexpr std::uint32_t vk_format_etc2_rgb8_unorm = 147;
+    constexpr std::uint32_t vk_format_etc2_rgba8_unorm = 151;
+
+    // Khronos data format descriptor values
+    constexpr std::uint8_t df_model_bc7 = 134;
+    constexpr std::uint8_t df_model_etc2 = 161;
+    constexpr std::uint8_t df_channel_bc7_color = 0;
+    constexpr std::uint8_t df_channel_etc2_color = 2;
+    constexpr std::uint8_t df_channel_etc2_alpha = 15;
+    constexpr std::uint8_t df_primaries_bt709 = 1;
+    constexpr std::uint8_t df_transfer_linear = 1;
+
+    constexpr std::size_t header_bytes = 12 + 9 * 4 + 4 * 4 + 2 * 8; // identifier, header, index
+    constexpr std::size_t level_index_entry_bytes = 3 * 8;
+
+    std::uint32_t vk_format_of(GLenum internal_format) {
+        switch (internal_format) {
+        case GL_COMPRESSED_RGBA_BPTC_UNORM: return vk_format_bc7_unorm;
+        case GL_COMPRESSED_RGB8_ETC2: return vk_format_etc2_rgb8_unorm;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC: return vk_format_etc2_rgba8_unorm;
+        default: return 0;
+        }
+    }
+
+    GLenum internal_format_of(std::uint32_t vk_format) {
+        switch (vk_format) {
+        case vk_format_bc7_unorm: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case vk_format_etc2_rgb8_unorm: return GL_COMPRESSED_RGB8_ETC2;
+        case vk_format_etc2_rgba8_unorm: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default: return 0;
+        }
+    }
+
+    // Little-endian fields, like every platform the app runs on
+    template<typename T>
+    void put(std::vector<std::uint8_t>& out, T value) {
+        std::uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    T get(const std::vector<std::uint8_t>& in, std::size_t offset) {
+        T value;
+        std::memcpy(&value, in.data() + offset, sizeof(T));
+        return value;
+    }
+
+    std::uint32_t sample_word(std::uint16_t bit_offset, std::uint8_t bit_length, std::uint8_t channel) {
+        return bit_offset | (static_cast<std::uint32_t>(bit_length - 1) << 16) | (static_cast<std::uint32_t>(channel) << 24);
+    }
+
+    // Basic data format descriptor: one sample per 64/128-bit part of a block
+    std::vector<std::uint8_t> make_dfd(GLenum internal_format) {
+        std::vector<std::uint32_t> samples;
+        std::uint8_t model = df_model_etc2;
+        switch (internal_format) {
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+            model = df_model_bc7;
+            samples = { sample_word(0, 128, df_channel_bc7_color), 0, 0, 0xFFFFFFFF };
+            break;
+        case GL_COMPRESSED_RGB8_ETC2:
+            samples = { sample_word(0, 64, df_channel_etc2_color), 0, 0, 0xFFFFFFFF };
+            break;
+        default: // GL_COMPRESSED_RGBA8_ETC2_EAC
+            samples = {
+                sample_word(0, 64, df_channel_etc2_alpha), 0, 0, 0xFFFFFFFF,
+                sample_word(64, 64, df_channel_etc2_color), 0, 0, 0xFFFFFFFF,
+            };
+            break;
+        }
+        std::uint32_t block_size = static_cast<std::uint32_t>(24 + samples.size() * 4);
+
+        std::vector<std::uint8_t> dfd;
+        put<std::uint32_t>(dfd, 4 + block_size); // total size
+        put<std::uint32_t>(dfd, 0);               // Khronos vendor, basic descriptor type
+        put<std::uint32_t>(dfd, 2 | (block_size << 16)); // version 2
+        put<std::uint32_t>(dfd, model | (df_primaries_bt709 << 8) | (df_transfer_linear << 16));
+        put<std::uint32_t>(dfd, 3 | (3 << 8));    // 4x4 texel blocks
+        put<std::uint32_t>(dfd, static_cast<std::uint32_t>(Ktx2::block_bytes(internal_format))); // bytes in plane 0
+        put<std::uint32_t>(dfd, 0);
+        for (auto word : samples) {
+            put<std::uint32_t>(dfd, word);
+        }
+        return dfd;
+    }
+
+    std::size_t align_up(std::size_t value, std::size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+std::size_t Ktx2::block_bytes(GLenum internal_format) {
+    switch (internal_format) {
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        return 16;
+    case GL_COMPRESSED_RGB8_ETC2:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+std::size_t Ktx2::level_bytes(GLenum internal_format, int width, int height) {
+    return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * block_bytes(internal_format);
+}
+
+std::filesystem::path Ktx2::cache_path(const std::filesystem::path& source) {
+    return source.parent_path() / "cache" / (source.filename().string() + ".ktx2");
+}
+
+bool Ktx2::is_cache_fresh(const std::filesystem::path& source) {
+    std::error_code error;
+    auto cache_time = std::filesystem::last_write_time(cache_path(source), error);
+    if (error) {
+        return false;
+    }
+    auto source_time = std::filesystem::last_write_time(source, error);
+    return !error && cache_time >= source_time;
+}
+
+bool Ktx2::write(const std::filesystem::path& path, const CompressedImage& image) {
+    std::uint32_t vk_format = vk_format_of(image.internal_format);
+    if (vk_format == 0 || image.levels.empty()) {
+        std::cerr << "KTX2: nothing to write or unsupported format: " << path << std::endl;
+        return false;
+    }
+
+    const std::size_t n_levels = image.levels.size();
+    const std::size_t alignment = block_bytes(image.internal_format) == 16 ? 16 : 8; // lcm(block size, 4)
+    std::vector<std::uint8_t> dfd = make_dfd(image.internal_format);
+    const std::size_t dfd_offset = header_bytes + n_levels * level_index_entry_bytes;
+
+    // Level data goes from the smallest level to the largest one
+    std::vector<std::uint64_t> level_offsets(n_levels);
+    std::size_t offset = dfd_offset + dfd.size();
+    for (std::size_t i = n_levels; i-- > 0;) {
+        offset = align_up(offset, alignment);
+        level_offsets[i] = offset;
+        offset += image.levels[i].size();
+    }
+
+    std::vector<std::uint8_t> out(identifier.begin(), identifier.end());
+    put<std::uint32_t>(out, vk_format);
+    put<std::uint32_t>(out, 1); // typeSize of block-compressed formats
+    put<std::uint32_t>(out, image.width);
+    put<std::uint32_t>(out, image.height);
+    put<std::uint32_t>(out, 0); // depth
+    put<std::uint32_t>(out, 0); // not an array
+    put<std::uint32_t>(out, 1); // faces
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(n_levels));
+    put<std::uint32_t>(out, 0); // no supercompression
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(dfd_offset));
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(dfd.size()));
+    put<std::uint32_t>(out, 0); // no key/value data
+    put<std::uint32_t>(out, 0);
+    put<std::uint64_t>(out, 0); // no supercompression global data
+    put<std::uint64_t>(out, 0);
+    for (std::size_t i = 0; i < n_levels; i++) {
+        put<std::uint64_t>(out, level_offsets[i]);
+        put<std::uint64_t>(out, image.levels[i].size());
+        put<std::uint64_t>(out, image.levels[i].size());
+    }
+    out.insert(out.end(), dfd.begin(), dfd.end());
+    for (std::size_t i = n_levels; i-- > 0;) {
+        out.resize(level_offsets[i], 0);
+        out.insert(out.end(), image.levels[i].begin(), image.levels[i].end());
+    }
+
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "KTX2: could not write: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return file.good();
+}
+
+std::optional<CompressedImage> Ktx2::read(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "KTX2: could not open: " << path << std::endl;
+        return std::nullopt;
+    }
+    std::vector<std::uint8_t> in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    auto fail = [&path](const char* reason) -> std::optional<CompressedImage> {
+        std::cerr << "KTX2: " << reason << ": " << path << std::endl;
+        return std::nullopt;
+    };
+
+    if (in.size() < header_bytes || !std::equal(identifier.begin(), identifier.end(), in.begin())) {
+        return fail("not a KTX2 file");
+    }
+    CompressedImage image{};
+    image.internal_format = internal_format_of(get<std::uint32_t>(in, 12));
+    image.width = static_cast<int>(get<std::uint32_t>(in, 20));
+    image.height = static_cast<int>(get<std::uint32_t>(in, 24));
+    std::uint32_t depth = get<std::uint32_t>(in, 28);
+    std::uint32_t layers = get<std::uint32_t>(in, 32);
+    std::uint32_t faces = get<std::uint32_t>(in, 36);
+    std::uint32_t n_levels = get<std::uint32_t>(in, 40);
+    std::uint32_t supercompression = get<std::uint32_t>(in, 44);
+
+    if (image.internal_format == 0) {
+        return fail("unsupported format");
+    }
+    if (depth != 0 || layers != 0 || faces != 1 || supercompression != 0 || n_levels == 0 || image.width <= 0 || image.height <= 0) {
+        return fail("only plain 2D textures with a mip chain are supported");
+    }
+    if (in.size() < header_bytes + n_levels * level_index_entry_bytes) {
+        return fail("truncated level index");
+    }
+
+    for (std::uint32_t i = 0; i < n_levels; i++) {
+        std::size_t entry = header_bytes + i * level_index_entry_bytes;
+        std::uint64_t offset = get<std::uint64_t>(in, entry);
+        std::uint64_t length = get<std::uint64_t>(in, entry + 8);
+        int level_width = std::max(image.width >> i, 1);
+        int level_height = std::max(image.height >> i, 1);
+        if (length != level_bytes(image.internal_format, level_width, level_height) || offset + length > in.size()) {
+            return fail("level size does not match the format");
+        }
+        image.levels.emplace_back(in.begin() + offset, in.begin() + offset + length);
+    }
+    return image;
+}
@@ -0,0 +1,73 @@
+#include <stdexcept>
+
+#include "render/PixelUploadRing.hpp"
+
+namespace {
+    void client_wait(GLsync fence) {
+        const GLuint64 timeout_ns = 1'000'000'000;
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence);
+    }
+}
+
+std::size_t PixelUploadRing::row_step(int cols, int type) {
+    std::size_t step = cols * CV_ELEM_SIZE(type);
+    return (step + 3) & ~std::size_t{ 3 }; // GL_UNPACK_ALIGNMENT is 4 by default
+}
+
+PixelUploadRing::PixelUploadRing(int cols, int rows, int type, std::size_t n_slots) : fences(n_slots, nullptr) {
+    if (!(cols > 0 && rows > 0) || n_slots == 0) {
+        throw std::runtime_error{ "the size of upload ring is zero" };
+    }
+    slot_size = (row_step(cols, type) * rows + 255) & ~std::size_t{ 255 }; // slots start on aligned offsets
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &name_);
+    glNamedBufferStorage(name_, slot_size * n_slots, nullptr, flags);
+    mapped = static_cast<std::byte*>(glMapNamedBufferRange(name_, 0, slot_size * n_slots, flags));
+    if (!mapped) {
+        glDeleteBuffers(1, &name_);
+        throw std::runtime_error{ "could not map the pixel upload buffer" };
+    }
+}
+
+PixelUploadRing::~PixelUploadRing() {
+    for (auto fence : fences) {
+        if (fence) {
+            client_wait(fence);
+        }
+    }
+    glUnmapNamedBuffer(name_);
+    glDeleteBuffers(1, &name_);
+}
+
+GLuint PixelUploadRing::get_name() const {
+    return name_;
+}
+
+PixelUploadRing::Slot PixelUploadRing::acquire(int cols, int rows, int type) {
+    std::size_t step = row_step(cols, type);
+    if (step * rows > slot_size) {
+        throw std::runtime_error{ "image does not fit into the upload ring slot" };
+    }
+
+    std::size_t index = next_slot;
+    next_slot = (next_slot + 1) % fences.size();
+
+    // Normally long done: the slot was used n_slots uploads ago
+    if (fences[index]) {
+        client_wait(fences[index]);
+        fences[index] = nullptr;
+    }
+
+    std::byte* data = mapped + index * slot_size;
+    return Slot{
+        cv::Mat(rows, cols, type, data, step),
+        static_cast<GLintptr>(index * slot_size),
+        index
+    };
+}
+
+void PixelUploadRing::release(const Slot& slot) {
+    fences[slot.index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+
+#include "render/RenderQueue.hpp"
+#include "render/GlState.hpp"
+
+void RenderQueue::submit(ShaderProgram* shader, Texture* texture, Mesh* mesh, const glm::mat4& model_matrix, GLint texture_index) {
+    if (texture_index >= 0) {
+        texture = nullptr; // resident, selected by index
+    }
+    items.push_back(DrawItem{ sort_key(shader, texture, mesh->get_vao()), shader, texture, mesh, model_matrix, texture_index, 0, 0, 0, 0, 0, 0, 0 });
+}
+
+void RenderQueue::submit_instanced(ShaderProgram* shader, Texture* texture, Mesh* mesh, GLsizei instance_count, GLuint base_instance) {
+    items.push_back(DrawItem{ sort_key(shader, texture, mesh->get_vao()), shader, texture, mesh, glm::mat4(1.0f), -1, instance_count, base_instance, 0, 0, 0, 0, 0 });
+}
+
+void RenderQueue::submit_multi_draw(ShaderProgram* shader, Texture* texture, GLuint vertex_array, GLenum primitive_type, GLuint indirect_buffer, GLintptr indirect_offset, GLsizei draw_count) {
+    items.push_back(DrawItem{ sort_key(shader, texture, vertex_array), shader, texture, nullptr, glm::mat4(1.0f), -1, 0, 0,
+        vertex_array, primitive_type, indirect_buffer, indirect_offset, draw_count });
+}
+
+void RenderQueue::flush() {
+    std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+
+    for (const auto& item : items) {
+        item.shader->use();
+        if (item.texture) {
+            item.texture->bind();
+        }
+
+        if (item.draw_count > 0) {
+            GlState::bind_vertex_array(item.vertex_array);
+            GlState::count_draw();
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, item.indirect_buffer);
+            glMultiDrawElementsIndirect(item.primitive_type, GL_UNSIGNED_INT, reinterpret_cast<const void*>(item.indirect_offset), item.draw_count, 0);
+            continue;
+        }
+        if (item.instance_count > 0) {
+            item.mesh->draw_instanced(item.instance_count, item.base_instance);
+            continue;
+        }
+        item.shader->set_uniform(model_matrix_id, item.model_matrix);
+        if (item.texture_index >= 0) {
+            item.shader->set_uniform(texture_index_id, item.texture_index);
+        }
+        item.mesh->draw();
+    }
+    items.clear();
+}
+
+std::uint64_t RenderQueue::sort_key(const ShaderProgram* shader, const Texture* texture, GLuint vertex_array) {
+    // GL names are small integers: 16 bits of program, 24 of texture, 24 of vertex array
+    std::uint64_t program = shader ? shader->get_ID() : 0;
+    std::uint64_t texture_name = texture ? texture->get_name() : 0;
+    return ((program & 0xffff) << 48) | ((texture_name & 0xffffff) << 24) | (vertex_array & 0xffffff);
+}
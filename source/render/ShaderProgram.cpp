@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -22,11 +23,18 @@ ShaderProgram::ShaderProgram(const std::string & vertex_shader_code, const std::
 
 	// link all compiled shaders into shader program 
     ID = link_shader(shader_ids);
+    reflect_uniforms();
 }
 
 ShaderProgram::ShaderProgram(const std::filesystem::path & VS_file, const std::filesystem::path & FS_file) :
     ShaderProgram{text_file_read(VS_file), text_file_read(FS_file)} {}
 
+ShaderProgram::ShaderProgram(const std::filesystem::path & CS_file) {
+    auto compute_shader = compile_shader(text_file_read(CS_file), GL_COMPUTE_SHADER);
+    ID = link_shader({ compute_shader });
+    reflect_uniforms();
+}
+
 // Get location or write error to console
 GLuint ShaderProgram::get_uniform_location(const std::string & name) {
     // deferred (lazy) cache generation
@@ -46,6 +54,48 @@ GLuint ShaderProgram::get_uniform_location(const std::string & name) {
     return loc;
 }
 
+GLint ShaderProgram::get_uniform_location(UniformId id) const {
+    auto found = std::lower_bound(uniform_locations.begin(), uniform_locations.end(), id.hash,
+        [](const std::pair<std::uint32_t, GLint>& entry, std::uint32_t hash) { return entry.first < hash; });
+    if (found == uniform_locations.end() || found->first != id.hash) {
+        return -1;
+    }
+    return found->second;
+}
+
+void ShaderProgram::reflect_uniforms() {
+    GLint n_uniforms = 0;
+    glGetProgramInterfaceiv(ID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &n_uniforms);
+    GLint max_name_length = 0;
+    glGetProgramInterfaceiv(ID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &max_name_length);
+
+    std::vector<char> name_buffer(max_name_length + 1);
+    for (GLint i = 0; i < n_uniforms; i++) {
+        const GLenum property = GL_LOCATION;
+        GLint location = -1;
+        glGetProgramResourceiv(ID, GL_UNIFORM, i, 1, &property, 1, nullptr, &location);
+        if (location == -1) {
+            continue; // member of a uniform block, set through its buffer
+        }
+        GLsizei length = 0;
+        glGetProgramResourceName(ID, GL_UNIFORM, i, static_cast<GLsizei>(name_buffer.size()), &length, name_buffer.data());
+        std::string name(name_buffer.data(), length);
+        if (name.ends_with("[0]")) {
+            name.resize(name.size() - 3); // arrays are set by their plain name
+        }
+
+        uniform_location_cache[name] = location;
+        uniform_locations.emplace_back(UniformId(name).hash, location);
+    }
+
+    std::sort(uniform_locations.begin(), uniform_locations.end());
+    for (std::size_t i = 1; i < uniform_locations.size(); i++) {
+        if (uniform_locations[i].first == uniform_locations[i - 1].first) {
+            std::cerr << "Two uniforms of shader program " << ID << " share a UniformId hash, rename one of them\n";
+        }
+    }
+}
+
 GLint ShaderProgram::get_attrib_location(const std::string & name) {
     GLint loc = glGetAttribLocation(ID, name.c_str());
     if (loc == -1)
@@ -4,6 +4,7 @@
 
 void SyncedTexture::fence_sync() {
     fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush(); // another context waits for it, an unflushed fence may never signal there
 }
 
 void SyncedTexture::fence_wait() {
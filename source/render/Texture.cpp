@@ -1,4 +1,10 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
 #include "render/Texture.hpp"
+#include "render/PixelUploadRing.hpp"
+#include "render/GlState.hpp"
 
 void Texture::gen_ckboard(void) {
     if (glIsTexture(ckboard_) != GL_TRUE) { // default checker-board texture yet not valid texture
@@ -29,6 +35,24 @@ cv::Mat Texture::load_image(const std::filesystem::path& path) {
     return image;
 }
 
+Texture::Image Texture::load_image_cached(const std::filesystem::path& path) {
+    if (Ktx2::is_cache_fresh(path)) {
+        if (auto compressed = Ktx2::read(Ktx2::cache_path(path))) {
+            return std::move(*compressed);
+        }
+        std::cerr << "Falling back to decoding: " << path << std::endl;
+    }
+    return load_image(path);
+}
+
+std::shared_ptr<Texture> Texture::create(const Image& image, Interpolation interpolation) {
+    return std::visit([interpolation](const auto& pixels) { return std::make_shared<Texture>(pixels, interpolation); }, image);
+}
+
+std::shared_ptr<Texture> Texture::load(const std::filesystem::path& path) {
+    return create(load_image_cached(path));
+}
+
 Texture::Texture(void) {
     Texture::gen_ckboard();
     name_ = Texture::ckboard_;
@@ -40,27 +64,37 @@ Texture::Texture(const glm::vec3& vec) : Texture{ cv::Mat{1, 1, CV_8UC3, cv::Sca
 
 Texture::Texture(const glm::vec4& vec) : Texture{ cv::Mat{1, 1, CV_8UC4, cv::Scalar{vec.b, vec.g, vec.r, vec.a}}, Interpolation::nearest } {}
 
-Texture::Texture(int cols, int rows, int type, Interpolation interpolation) : Texture{}
+Texture::Texture(int cols, int rows, int type, Interpolation interpolation, Origin origin, MipUpdate mip_update) : Texture{}
 {
     if (!(cols > 0 && rows > 0)) {
         throw std::runtime_error{ "the size of texture image is zero" };
     }
 
     glCreateTextures(GL_TEXTURE_2D, 1, &name_);
+    width_ = cols;
+    height_ = rows;
+    origin_ = origin;
+    mip_update_ = mip_update;
+    if (interpolation == Interpolation::linear_mipmap_linear) {
+        levels_ = 1 + static_cast<GLsizei>(std::floor(std::log2(std::max(cols, rows)))); // full chain down to 1x1
+    }
 
     switch (type) {
     case CV_8UC1: // single channel image - greyscale
         // upload only one channel
-        glTextureStorage2D(name_, 1, GL_R8, cols, rows);
+        glTextureStorage2D(name_, levels_, GL_R8, cols, rows);
+        internal_format_ = GL_R8;
         // use data also for other channels
         glTextureParameteri(name_, GL_TEXTURE_SWIZZLE_G, GL_RED);
         glTextureParameteri(name_, GL_TEXTURE_SWIZZLE_B, GL_RED);
         break;
     case CV_8UC3:  // RGB
-        glTextureStorage2D(name_, 1, GL_RGB8, cols, rows);
+        glTextureStorage2D(name_, levels_, GL_RGB8, cols, rows);
+        internal_format_ = GL_RGB8;
         break;
     case CV_8UC4:  // RGBA
-        glTextureStorage2D(name_, 1, GL_RGBA8, cols, rows);
+        glTextureStorage2D(name_, levels_, GL_RGBA8, cols, rows);
+        internal_format_ = GL_RGBA8;
         break;
     default:
         throw std::runtime_error{ "unsupported number of channels or channel depth in texture" };
@@ -77,8 +111,42 @@ Texture::Texture(cv::Mat const& image, Interpolation interpolation) : Texture{im
     replace_image(image);
 }
 
+Texture::Texture(const CompressedImage& image, Interpolation interpolation) : Texture{}
+{
+    if (!(image.width > 0 && image.height > 0) || image.levels.empty()) {
+        throw std::runtime_error{ "the size of texture image is zero" };
+    }
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &name_);
+    width_ = image.width;
+    height_ = image.height;
+    internal_format_ = image.internal_format;
+    levels_ = interpolation == Interpolation::linear_mipmap_linear ? static_cast<GLsizei>(image.levels.size()) : 1;
+
+    glTextureStorage2D(name_, levels_, internal_format_, width_, height_);
+    for (GLsizei level = 0; level < levels_; level++) {
+        const auto& blocks = image.levels[level];
+        glCompressedTextureSubImage2D(name_, level, 0, 0, std::max(width_ >> level, 1), std::max(height_ >> level, 1),
+            internal_format_, static_cast<GLsizei>(blocks.size()), blocks.data());
+    }
+
+    set_interpolation(interpolation); // the chain is complete, nothing is generated
+
+    // Configures the way the texture repeats
+    glTextureParameteri(name_, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(name_, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
 Texture::~Texture() {
     glDeleteTextures(1, &name_);
+    GlState::texture_deleted(name_);
+}
+
+void Texture::release_storage() {
+    glDeleteTextures(1, &name_);
+    GlState::texture_deleted(name_);
+    name_ = 0;
+    levels_ = 0;
 }
 
 GLuint Texture::get_name() const {
@@ -86,7 +154,7 @@ GLuint Texture::get_name() const {
 }
 
 void Texture::bind(void) {
-    glBindTextureUnit(0, name_); // bind to some texturing unit, e.g. 0
+    GlState::bind_texture_unit(0, name_); // bind to some texturing unit, e.g. 0 (skipped if already bound)
 }
 
 void Texture::set_interpolation(Interpolation interpolation) {
@@ -106,58 +174,138 @@ void Texture::set_interpolation(Interpolation interpolation) {
         // Trilinear: MIPMAP filtering + automatic MIPMAP generation - nicest, needs more memory. Notice: MIPMAP is only for image minifying.
         glTextureParameteri(name_, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // bilinear magnifying
         glTextureParameteri(name_, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // trilinear minifying
-        glGenerateTextureMipmap(name_);  // Generate mipmaps now.
+        if (mip_update_ == MipUpdate::on_upload) {
+            update_mipmaps();  // Generate mipmaps now (if there is an image already).
+        }
         break;
     }
 }
 
-int Texture::get_height(void) {
-    int tex_height = 0;
-    int basemiplevel = 0; // base image
-    glGetTextureLevelParameteriv(name_, basemiplevel, GL_TEXTURE_HEIGHT, &tex_height);
+void Texture::update_mipmaps() {
+    if (mips_stale_) {
+        glGenerateTextureMipmap(name_);
+        mips_stale_ = false;
+    }
+}
 
-    return tex_height;
+void Texture::image_replaced() {
+    // only level 0 was written, the rest of the chain shows the previous image
+    mips_stale_ = levels_ > 1;
+    if (mip_update_ == MipUpdate::on_upload) {
+        update_mipmaps();
+    }
 }
 
-int Texture::get_width(void) {
-    int tex_width = 0;
-    int basemiplevel = 0; // base image
-    glGetTextureLevelParameteriv(name_, basemiplevel, GL_TEXTURE_WIDTH, &tex_width);
+int Texture::get_height(void) {
+    return height_;
+}
 
-    return tex_width;
+int Texture::get_width(void) {
+    return width_;
 }
 
-void Texture::replace_image(const cv::Mat& image) {
+void Texture::check_replacement(const cv::Mat& image) const {
     // immutable texture format used: only content can be changed (size and data format MUST match)
 
     // check size
-    if ((image.rows != get_height()) || (image.cols != get_width()))
+    if ((image.rows != height_) || (image.cols != width_))
         throw std::runtime_error("improper image replacement size");
 
-    cv::flip(image, image, 0);  // OpenGL vs. Window coordinates...
-
     // check channels and format
-    int tex_format = 0;
-    int basemiplevel = 0; // base image
-    glGetTextureLevelParameteriv(name_, basemiplevel, GL_TEXTURE_INTERNAL_FORMAT, &tex_format);
-
     switch (image.type()) {
     case CV_8UC1: // single channel image - greyscale
-        if (tex_format != GL_R8)
+        if (internal_format_ != GL_R8)
             throw std::runtime_error("improper image replacement channel data, GL_R8 was the original");
-        glTextureSubImage2D(name_, 0, 0, 0, image.cols, image.rows, GL_RED, GL_UNSIGNED_BYTE, image.data);
         break;
     case CV_8UC3:  // RGB
-        if (tex_format != GL_RGB8)
+        if (internal_format_ != GL_RGB8)
             throw std::runtime_error("improper image replacement channel data, GL_RGB8 was the original");
-        glTextureSubImage2D(name_, 0, 0, 0, image.cols, image.rows, GL_BGR, GL_UNSIGNED_BYTE, image.data);
         break;
     case CV_8UC4:  // RGBA
-        if (tex_format != GL_RGBA8)
+        if (internal_format_ != GL_RGBA8)
             throw std::runtime_error("improper image replacement channel data, GL_RGBA8 was the original");
-        glTextureSubImage2D(name_, 0, 0, 0, image.cols, image.rows, GL_BGRA, GL_UNSIGNED_BYTE, image.data);
         break;
     default:
         throw std::runtime_error{ "unsupported number of channels or channel depth in texture" };
     }
 }
+
+std::size_t Texture::get_memory_bytes() const {
+    std::size_t bytes = 0;
+    for (GLsizei level = 0; level < levels_; level++) {
+        int level_width = std::max(width_ >> level, 1);
+        int level_height = std::max(height_ >> level, 1);
+        switch (internal_format_) {
+        case GL_R8:
+            bytes += static_cast<std::size_t>(level_width) * level_height;
+            break;
+        case GL_RGB8:
+            bytes += static_cast<std::size_t>(level_width) * level_height * 3;
+            break;
+        case GL_RGBA8:
+            bytes += static_cast<std::size_t>(level_width) * level_height * 4;
+            break;
+        default: // compressed
+            bytes += Ktx2::level_bytes(internal_format_, level_width, level_height);
+            break;
+        }
+    }
+    return bytes;
+}
+
+GLenum Texture::pixel_format() const {
+    // OpenCV keeps the channels in BGR(A) order
+    switch (internal_format_) {
+    case GL_R8:
+        return GL_RED;
+    case GL_RGBA8:
+        return GL_BGRA;
+    default:
+        return GL_BGR;
+    }
+}
+
+Texture::Origin Texture::get_origin() const {
+    return origin_;
+}
+
+glm::vec2 Texture::uv_top_left() const {
+    return origin_ == Origin::top_left ? glm::vec2(0.0f, 0.0f) : glm::vec2(0.0f, 1.0f);
+}
+
+glm::vec2 Texture::uv_bottom_right() const {
+    return origin_ == Origin::top_left ? glm::vec2(1.0f, 1.0f) : glm::vec2(1.0f, 0.0f);
+}
+
+void Texture::replace_image(const cv::Mat& image) {
+    check_replacement(image);
+
+    cv::Mat upload = image;
+    if (origin_ == Origin::bottom_left) {
+        upload = cv::Mat();
+        cv::flip(image, upload, 0);  // OpenGL vs. Window coordinates... into a new image, the caller's one stays as it was
+    }
+
+    glTextureSubImage2D(name_, 0, 0, 0, upload.cols, upload.rows, pixel_format(), GL_UNSIGNED_BYTE, upload.data);
+    image_replaced();
+}
+
+void Texture::replace_image(const cv::Mat& image, PixelUploadRing& ring) {
+    check_replacement(image);
+
+    // The only CPU pass is the copy into the mapped slot (flipped on the way if needed), the GPU then reads the slot asynchronously
+    PixelUploadRing::Slot slot = ring.acquire(image.cols, image.rows, image.type());
+    if (origin_ == Origin::bottom_left) {
+        cv::flip(image, slot.image, 0);  // OpenGL vs. Window coordinates...
+    }
+    else {
+        image.copyTo(slot.image);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.get_name());
+    glTextureSubImage2D(name_, 0, 0, 0, image.cols, image.rows, pixel_format(), GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(slot.offset));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    ring.release(slot);
+    image_replaced();
+}
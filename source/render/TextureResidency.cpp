@@ -0,0 +1,136 @@
+#include <cmath>
+#include <iostream>
+
+#include "render/TextureResidency.hpp"
+#include "render/ShaderProgram.hpp"
+#include "render/GlState.hpp"
+
+TextureResidency::TextureResidency() {
+    mode = GLEW_ARB_bindless_texture ? Mode::bindless : Mode::array;
+    std::cout << "Texture residency: " << (mode == Mode::bindless ? "bindless handles" : "texture array") << std::endl;
+}
+
+TextureResidency::Mode TextureResidency::get_mode() const {
+    return mode;
+}
+
+std::filesystem::path TextureResidency::fragment_shader_path() const {
+    return mode == Mode::bindless ? "resources/texture_sdr/tex_bindless.frag" : "resources/texture_sdr/tex_array.frag";
+}
+
+int TextureResidency::add(const std::shared_ptr<Texture>& texture) {
+    if (auto found = indices.find(texture.get()); found != indices.end()) {
+        return found->second;
+    }
+    if (array_name || handle_buffer) {
+        throw std::runtime_error{ "textures must be added before they are made resident" };
+    }
+    int index = static_cast<int>(textures.size());
+    textures.push_back(texture);
+    indices.emplace(texture.get(), index);
+    return index;
+}
+
+int TextureResidency::index_of(const Texture* texture) const {
+    auto found = indices.find(texture);
+    return found == indices.end() ? -1 : found->second;
+}
+
+void TextureResidency::make_resident() {
+    if (textures.empty()) {
+        return;
+    }
+    if (mode == Mode::bindless) {
+        build_handles();
+    }
+    else {
+        build_array();
+    }
+}
+
+void TextureResidency::build_handles() {
+    // A handle freezes the texture's sampler state, the textures are complete by now
+    for (const auto& texture : textures) {
+        GLuint64 handle = glGetTextureHandleARB(texture->get_name());
+        glMakeTextureHandleResidentARB(handle);
+        handles.push_back(handle);
+    }
+    glCreateBuffers(1, &handle_buffer);
+    glNamedBufferStorage(handle_buffer, handles.size() * sizeof(GLuint64), handles.data(), 0);
+}
+
+void TextureResidency::build_array() {
+    // Layers must share size and format: every texture (compressed or not) is drawn into its layer, resampled
+    const GLsizei layer_size = TEXTURE_ARRAY_LAYER_SIZE;
+    const GLsizei levels = 1 + static_cast<GLsizei>(std::log2(layer_size));
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &array_name);
+    glTextureStorage3D(array_name, levels, GL_RGBA8, layer_size, layer_size, static_cast<GLsizei>(textures.size()));
+    glTextureParameteri(array_name, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(array_name, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(array_name, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(array_name, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    ShaderProgram copy_shader(std::filesystem::path("resources/texture_sdr/layer_copy.vert"), std::filesystem::path("resources/texture_sdr/layer_copy.frag"));
+    GLuint framebuffer = 0, vao = 0;
+    glCreateFramebuffers(1, &framebuffer);
+    glCreateVertexArrays(1, &vao); // the full-screen triangle comes from gl_VertexID
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_BLEND);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, layer_size, layer_size);
+    GlState::bind_vertex_array(vao);
+    copy_shader.use();
+
+    for (std::size_t layer = 0; layer < textures.size(); layer++) {
+        glNamedFramebufferTextureLayer(framebuffer, GL_COLOR_ATTACHMENT0, array_name, 0, static_cast<GLint>(layer));
+        if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Texture array layer " << layer << " is not renderable" << std::endl;
+            continue;
+        }
+        textures[layer]->bind();
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    copy_shader.deactivate();
+    GlState::bind_vertex_array(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (blend) {
+        glEnable(GL_BLEND);
+    }
+    glDeleteVertexArrays(1, &vao);
+    GlState::vertex_array_deleted(vao);
+    glDeleteFramebuffers(1, &framebuffer);
+
+    glGenerateTextureMipmap(array_name);
+
+    // The layers are uncompressed copies, keeping the sources too would hold every texture twice in VRAM
+    std::size_t released_bytes = 0;
+    for (const auto& texture : textures) {
+        released_bytes += texture->get_memory_bytes();
+        texture->release_storage();
+    }
+    std::cout << "Texture array: " << textures.size() << " layers of " << layer_size << "x" << layer_size << " RGBA8, "
+        << released_bytes / 1024 << " KiB of source textures released" << std::endl;
+}
+
+void TextureResidency::bind() const {
+    if (array_name) {
+        GlState::bind_texture_unit(TEXTURE_ARRAY_UNIT, array_name);
+    }
+    if (handle_buffer) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TEXTURE_HANDLES_BINDING, handle_buffer);
+    }
+}
+
+TextureResidency::~TextureResidency() {
+    for (auto handle : handles) {
+        glMakeTextureHandleNonResidentARB(handle);
+    }
+    glDeleteBuffers(1, &handle_buffer);
+    glDeleteTextures(1, &array_name);
+    GlState::texture_deleted(array_name);
+}
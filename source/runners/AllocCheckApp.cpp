@@ -0,0 +1,112 @@
+#include <iostream>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+#include "runners/AllocCheckApp.hpp"
+#include "recognizers/DetectionFrame.hpp"
+#include "recognizers/FaceRecognizer.hpp"
+#include "recognizers/RedRecognizer.hpp"
+#include "utils/AllocationCounter.hpp"
+
+AllocCheckApp::AllocCheckApp() {
+    // Constructor
+}
+
+bool AllocCheckApp::init() {
+    if (!AllocationCounter::enabled()) {
+        std::cerr << "Error: Allocation counting is not built in, use the ALLOCCHECK run mode.\n";
+        return false;
+    }
+
+    image = cv::imread(image_path);
+    if (image.empty()) {
+        std::cerr << "Error: Could not load " << image_path << std::endl;
+        return false;
+    }
+
+    // Same working scales as the app
+    std::ifstream file("resources/config.json");
+    if (file.is_open()) {
+        try {
+            nlohmann::json j;
+            file >> j;
+            if (j.contains("tracker")) {
+                face_scale = j["tracker"].value("face_scale", face_scale);
+                red_scale = j["tracker"].value("red_scale", red_scale);
+            }
+        }
+        catch (std::exception& e) {
+            std::cerr << "Error parsing JSON: " << e.what() << std::endl;
+        }
+    }
+
+    cv::setNumThreads(1); // like GLApp, OpenCV's thread pool is not used
+    return true;
+}
+
+int AllocCheckApp::run() {
+    // Everything a detector lane keeps from frame to frame
+    FaceRecognizer face_recognizer;
+    RedRecognizer red_recognizer;
+    DetectionFrame detection_frame;
+    FaceWorkspace face_workspace;
+    FaceCenters faces;
+    cv::Point2f red;
+
+    if (!face_recognizer.init()) {
+        return EXIT_FAILURE;
+    }
+    face_recognizer.set_working_scale(face_scale);
+    red_recognizer.set_working_scale(red_scale);
+    const int face_level = DetectionFrame::level_for(face_scale);
+    const int red_level = DetectionFrame::level_for(red_scale);
+
+    std::size_t n_pyramid = 0, n_red = 0, n_gray = 0, n_face = 0;
+    for (int i = 0; i < n_warmup_frames + n_frames; i++) {
+        bool counted = i >= n_warmup_frames;
+
+        auto before = AllocationCounter::count();
+        detection_frame.reset(image);
+        detection_frame.bgr(face_level);
+        detection_frame.bgr(red_level);
+        auto after_pyramid = AllocationCounter::count();
+        red = red_recognizer.find_red(detection_frame);
+        auto after_red = AllocationCounter::count();
+        detection_frame.gray(face_level);
+        auto after_gray = AllocationCounter::count();
+        face_recognizer.find_face(detection_frame, face_workspace, faces);
+        auto after_face = AllocationCounter::count();
+
+        if (counted) {
+            n_pyramid += after_pyramid - before;
+            n_red += after_red - after_pyramid;
+            n_gray += after_gray - after_red;
+            n_face += after_face - after_gray;
+        }
+    }
+
+    std::cout << "Heap allocations in " << n_frames << " frames (after " << n_warmup_frames << " warm-up frames), "
+        << image_path << ", face scale " << face_scale << ", red scale " << red_scale << ":\n";
+    print_stage("pyramid", n_pyramid, true);
+    print_stage("red kernel", n_red, true);
+    print_stage("gray conversion (cv::cvtColor)", n_gray, false);
+    print_stage("face detection (cv::CascadeClassifier)", n_face, false);
+    std::cout << "Last result: " << faces.size() << " faces, red at " << red << ", "
+        << face_recognizer.dropped_faces() << " faces over the limit of " << FACE_MAX_FACES << " dropped in total\n";
+    std::cout << "Only the pyramid and the red kernel are checked for zero allocations;"
+        " cv::cvtColor and cv::CascadeClassifier still allocate every frame\n";
+
+    bool passed = n_pyramid == 0 && n_red == 0;
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void AllocCheckApp::print_stage(const std::string& name, std::size_t n_allocations, bool must_be_zero) {
+    std::cout << "  " << name << ": " << n_allocations << " (" << static_cast<double>(n_allocations) / n_frames << " per frame)"
+        << (must_be_zero ? (n_allocations == 0 ? " OK" : " FAIL, must be 0") : " inside OpenCV, reported only") << "\n";
+}
+
+AllocCheckApp::~AllocCheckApp()
+{
+}
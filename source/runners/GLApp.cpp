@@ -1,7 +1,9 @@
 #include <thread>
 #include <optional>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <chrono>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -18,10 +20,13 @@
 #include <tinyfiledialogs/tinyfiledialogs.h>
 
 #include "runners/GLApp.hpp"
+#include "concurrency/TaskScheduler.hpp"
 #include "render/Drawings.hpp"
 #include "render/SyncedTexture.hpp"
+#include "render/PixelUploadRing.hpp"
 #include "utils/GlDebugCallback.hpp"
 #include "utils/Screenshot.hpp"
+#include "utils/Profiler.hpp"
 #include "scenes/ShooterScene.hpp"
 #include "scenes/ViewerScene.hpp"
 
@@ -42,6 +47,27 @@ bool GLApp::load_config(const std::string& filename) {
 
         window_width = j["window"]["width"].get<int>();
         window_height = j["window"]["height"].get<int>();
+
+        if (j.contains("tracker")) {
+            auto channel = j["tracker"].value("channel", std::string("mailbox"));
+            if (channel == "queue") {
+                tracker_channel = TrackerChannel::queue;
+            }
+            else if (channel == "mailbox") {
+                tracker_channel = TrackerChannel::mailbox;
+            }
+            else {
+                std::cerr << "Unknown tracker channel: " << channel << ", using mailbox\n";
+            }
+            n_detector_workers = j["tracker"].value("detector_workers", std::size_t{ 0 });
+            face_tracking_on = j["tracker"].value("face_tracking", true);
+            face_full_scan_interval = j["tracker"].value("face_full_scan_interval", FACE_FULL_SCAN_INTERVAL);
+            face_working_scale = j["tracker"].value("face_scale", 1.0f);
+            red_working_scale = j["tracker"].value("red_scale", 1.0f);
+        }
+        if (j.contains("source")) {
+            frame_source_config = FrameSource::config_from_json(j["source"]);
+        }
     }
     catch (std::exception& e) {
         std::cerr << "Error parsing JSON: " << e.what() << std::endl;
@@ -141,24 +167,50 @@ bool GLApp::init() {
     } else if (gl_profile_mask & GL_CONTEXT_COMPATIBILITY_PROFILE_BIT) {
         gl_profile = "compatibility";
     }
+
+    // Frame timing
+    scene_gpu_timer = std::make_unique<GpuTimer>();
+    imgui_gpu_timer = std::make_unique<GpuTimer>();
     
     // Init tracking
-    face_recognizer.init();
-    if (!capture_device.open(0)) {
-        std::cerr << "Error: Could not open camera.\n";
+    // Parallelism comes from the pipeline and the task scheduler, OpenCV's own thread pool would only oversubscribe the cores
+    cv::setNumThreads(1);
+    if (n_detector_workers == 0) {
+        // leave a core for the render loop and one for capture + upload
+        auto n_cores = static_cast<std::size_t>(std::thread::hardware_concurrency());
+        n_detector_workers = std::clamp<std::size_t>(n_cores > 2 ? n_cores - 2 : 1, 1, 4);
+    }
+    for (std::size_t i = 0; i < n_detector_workers; i++) {
+        auto lane = std::make_unique<DetectorLane>();
+        lane->app = this;
+        if (!lane->face_recognizer.init()) {
+            return false;
+        }
+        // every lane tracks from the frames it detected itself, the ROI padding covers the gap between them
+        lane->face_recognizer.set_tracking(face_tracking_on, face_full_scan_interval);
+        lane->face_recognizer.set_working_scale(face_working_scale);
+        lane->red_recognizer.set_working_scale(red_working_scale);
+        detector_lanes.push_back(std::move(lane));
+    }
+    std::cout << "Tracker detector lanes: " << n_detector_workers << ", scheduler workers: " << TaskScheduler::global().worker_count() << "\n";
+
+    frame_source = FrameSource::create(frame_source_config);
+    if (!frame_source) {
         return false;
     }
-    camera_width = (int)capture_device.get(cv::CAP_PROP_FRAME_WIDTH);
-    camera_height = (int)capture_device.get(cv::CAP_PROP_FRAME_HEIGHT);
+    camera_width = frame_source->size().width;
+    camera_height = frame_source->size().height;
     frame_pool.init(
         camera_width,
         camera_height,
         CV_8UC3,
-        SyncedTexture::Interpolation::linear_mipmap_linear
+        SyncedTexture::Interpolation::linear_mipmap_linear,
+        SyncedTexture::Origin::top_left,   // uploaded as captured, without a flip
+        SyncedTexture::MipUpdate::on_demand // mips only for frames that are actually shown minified
     );
     default_recognized_data = RecognizedData{
-        std::make_unique<SyncedTexture>(),
-        std::vector<cv::Point2f>{},
+        Lease<SyncedTexture>(std::make_unique<SyncedTexture>()),
+        FaceCenters{},
         cv::Point2f{}
     };
 
@@ -207,19 +259,36 @@ bool GLApp::run() {
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 
     // Run tracker
-    tracker_thread = std::jthread(&GLApp::tracker_worker, this);
+    start_tracker();
 
     std::optional<RecognizedData> current_recognized_data;
 
+    PROFILE_THREAD("render loop");
     while (!glfwWindowShouldClose(window)) {
+        PROFILE_ZONE("frame");
+        auto frame_start = std::chrono::steady_clock::now();
+
         // Reinitializations
         title_string.str("");
         title_string.clear();
 
         // Get recognized data
-        if (auto new_recognized_data = de_queue.try_pop_front()) {
-            if (current_recognized_data) frame_pool.release(std::move(current_recognized_data->frame));
-            current_recognized_data = std::move(*new_recognized_data);
+        {
+            PROFILE_ZONE("take recognized data");
+            if (auto new_recognized_data = take_recognized_data()) {
+                current_recognized_data = std::move(*new_recognized_data); // the previous frame goes back to the pool
+                if (current_recognized_data->upload_gpu_ms >= 0.0f) {
+                    upload_gpu_times.add(current_recognized_data->upload_gpu_ms);
+                }
+            }
+        }
+
+        // GPU times of earlier frames, only those already finished
+        while (auto ms = scene_gpu_timer->poll_ms()) {
+            scene_gpu_times.add(static_cast<float>(*ms));
+        }
+        while (auto ms = imgui_gpu_timer->poll_ms()) {
+            imgui_gpu_times.add(static_cast<float>(*ms));
         }
         const RecognizedData& recognized_data = current_recognized_data ? *current_recognized_data : default_recognized_data;
 
@@ -227,55 +296,82 @@ bool GLApp::run() {
         active_scene->set_enabled(recognized_data.faces.size() == 1);
 
         // Prepare imgui render
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+        {
+            PROFILE_ZONE("ImGui");
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
 
-        show_crosshair();
+            show_crosshair();
 
-        // The info window
-        ImGui::SetNextWindowPos(ImVec2(10, 10));
-        if (imgui_full) {
-            ImGui::SetNextWindowSize(ImVec2(250, 220));
-        }
-        else {
-            ImGui::SetNextWindowSize(ImVec2(250, 150));
-        }
-        ImGui::Begin("Info", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
-        ImGui::Text("V-Sync: %s", vsync_on ? "ON" : "OFF");
-        ImGui::Text("Antialiasing %s", antialiasing_on ? "ON" : "OFF");
-        ImGui::Text("FPS: %.1f", FPS_main.get());
-        ImGui::Text("GL Version: %s", gl_version.c_str());
-        ImGui::Text("GL Profile: %s", gl_profile.c_str());
-        ImGui::Text("Controls:");
-        ImGui::Text("U - show/hide more info and camera");
-
-        if (imgui_full) {
-            ImGui::Text("V - VSync on/off");
-            ImGui::Text("T - Antialising on/off");
-            ImGui::Text("P - take screenshot");
-            ImGui::Text("F11 - Fullscreen/Windowed");
-        }
-        ImGui::End();
-        if (imgui_full) {
-            ImGui::SetNextWindowPos(ImVec2(window_width-300-10, 10));
-            ImGui::SetNextWindowSize(ImVec2(300, 210));
-            ImGui::Begin("Scene info", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
-            active_scene->display_controls();
+            // The info window
+            ImGui::SetNextWindowPos(ImVec2(10, 10));
+            if (imgui_full) {
+                ImGui::SetNextWindowSize(ImVec2(250, Profiler::enabled() ? 335 : 320));
+            }
+            else {
+                ImGui::SetNextWindowSize(ImVec2(250, 170));
+            }
+            ImGui::Begin("Info", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
+            ImGui::Text("V-Sync: %s", vsync_on ? "ON" : "OFF");
+            ImGui::Text("Antialiasing %s", antialiasing_on ? "ON" : "OFF");
+            ImGui::Text("FPS: %.1f", FPS_main.get());
+            ImGui::Text("Dropped camera frames: %zu", dropped_frames());
+            if (imgui_full) {
+                auto pool_stats = frame_pool.stats();
+                ImGui::Text("Frame pool: %zu alloc, %zu peak", pool_stats.allocated, pool_stats.high_water);
+                ImGui::Text("  hits %zu/%zu, miss %zu, waits %zu", pool_stats.cache_hits, pool_stats.shared_hits, pool_stats.misses, pool_stats.blocked_waits);
+                ImGui::Text("Draws: %zu, binds: %zu", scene_gl_counters.draws, scene_gl_counters.binds);
+                ImGui::Text("  state changes: %zu", scene_gl_counters.state_changes);
+                ImGui::Text("Faces over limit (%d): %zu", FACE_MAX_FACES, dropped_faces());
+            }
+            ImGui::Text("GL Version: %s", gl_version.c_str());
+            ImGui::Text("GL Profile: %s", gl_profile.c_str());
+            ImGui::Text("Controls:");
+            ImGui::Text("U - show/hide more info and camera");
+
+            if (imgui_full) {
+                ImGui::Text("V - VSync on/off");
+                ImGui::Text("T - Antialising on/off");
+                ImGui::Text("P - take screenshot");
+                ImGui::Text("F11 - Fullscreen/Windowed");
+                if (Profiler::enabled()) {
+                    ImGui::Text("F12 - save profile to trace.json");
+                }
+            }
             ImGui::End();
+            if (imgui_full) {
+                ImGui::SetNextWindowPos(ImVec2(window_width-300-10, 10));
+                ImGui::SetNextWindowSize(ImVec2(300, 280));
+                ImGui::Begin("Scene info", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
+                active_scene->display_controls();
+                ImGui::End();
 
-        }
+            }
 
-        if (imgui_full) {
-            // The camera window
-            ImVec2 cameraSize((int)((float)camera_width / camera_height * 150), 150);
-            ImGui::SetNextWindowPos(ImVec2(10, window_height - cameraSize[1] - 10));
-            ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0));
-            ImGui::SetNextWindowSize(cameraSize);
-            ImGui::Begin("Camera", nullptr, ImGuiWindowFlags_NoDecoration);
-            ImGui::Image((ImTextureID)(intptr_t)recognized_data.frame->get_name(), cameraSize, ImVec2(0, 1), ImVec2(1, 0));
-            ImGui::End();
-            ImGui::PopStyleVar();
+            if (imgui_full) {
+                show_frame_times();
+            }
+
+            if (imgui_full) {
+                // The camera window
+                ImVec2 cameraSize((int)((float)camera_width / camera_height * 150), 150);
+                ImGui::SetNextWindowPos(ImVec2(10, window_height - cameraSize[1] - 10));
+                ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0));
+                ImGui::SetNextWindowSize(cameraSize);
+                ImGui::Begin("Camera", nullptr, ImGuiWindowFlags_NoDecoration);
+                // the upload ran on the tracker's context, the GPU waits for it before mips are built or sampled
+                recognized_data.frame->fence_wait();
+                if (cameraSize.y < camera_height) {
+                    recognized_data.frame->update_mipmaps(); // once per shown frame, frames dropped or hidden never pay for it
+                }
+                // the camera frames are not flipped on upload, the corners say which way up the texture is
+                auto uv0 = recognized_data.frame->uv_top_left();
+                auto uv1 = recognized_data.frame->uv_bottom_right();
+                ImGui::Image((ImTextureID)(intptr_t)recognized_data.frame->get_name(), cameraSize, ImVec2(uv0.x, uv0.y), ImVec2(uv1.x, uv1.y));
+                ImGui::End();
+                ImGui::PopStyleVar();
+            }
         }
 
         // drawing
@@ -291,20 +387,43 @@ bool GLApp::run() {
         }
 
         // Update scene
-        active_scene->update(delta_time);
+        {
+            PROFILE_ZONE("update");
+            active_scene->update(delta_time);
+        }
 
         // Render scene
-        active_scene->render();
+        {
+            PROFILE_ZONE("render");
+            scene_gpu_timer->begin();
+            GlState::invalidate(); // ImGui binds behind the cache's back
+            GlState::reset_counters();
+            active_scene->render();
+            scene_gl_counters = GlState::counters();
+            scene_gpu_timer->end();
+        }
 
         // display imgui
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            PROFILE_ZONE("ImGui render");
+            ImGui::Render();
+            imgui_gpu_timer->begin();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            imgui_gpu_timer->end();
+        }
+        cpu_frame_times.add(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frame_start).count());
 
         // Switch background and foreground buffers (rendering is always done in background first)
-        glfwSwapBuffers(window);
+        {
+            PROFILE_ZONE("swap");
+            glfwSwapBuffers(window);
+        }
 
         // Check key, mouse events
-        glfwPollEvents();
+        {
+            PROFILE_ZONE("poll events");
+            glfwPollEvents();
+        }
 
         // FPS counter
         if (FPS_main.is_updated()) {
@@ -320,51 +439,186 @@ bool GLApp::run() {
     }
 
     ended_main = true;
+    tracker_stop.request_stop(); // wakes the tracker stages wherever they are blocked
 
     return true;
 }
 
-void GLApp::tracker_worker() {
-    cv::Mat cv_frame;
-    std::unique_ptr<SyncedTexture> frame;
-    std::vector<cv::Point2f> faces;
-    cv::Point2f red;
+#pragma region Tracker
+void GLApp::start_tracker() {
+    auto stop = tracker_stop.get_token();
+    capture_thread = std::jthread([this, stop]() { capture_worker(stop); });
+    upload_thread = std::jthread([this, stop]() { upload_worker(stop); });
+}
 
-    glfwMakeContextCurrent(tracker_worker_window);
+void GLApp::stop_tracker() {
+    tracker_stop.request_stop();
+    if (capture_thread.joinable()) capture_thread.join();
+    // Detections still running on the scheduler use the lanes, wait until all of them are done
+    auto detecting = [this]() {
+        return std::any_of(detector_lanes.begin(), detector_lanes.end(), [](const auto& lane) { return lane->state.load() == LaneState::detecting; });
+    };
+    TaskScheduler::global().help_until([&detecting]() { return !detecting(); });
+    if (upload_thread.joinable()) upload_thread.join();
+}
 
-    while (!ended_main && !ended_tracker_thread) {
-        capture_device.read(cv_frame);
-        if (cv_frame.empty()) {
+void GLApp::capture_worker(std::stop_token stop) {
+    // Stage 1: grab frames straight into the next lane in turn, as soon as it is free, and start its detection
+    std::uint64_t sequence = 0;
+    PROFILE_THREAD("tracker capture");
+
+    while (!ended_main && !stop.stop_requested()) {
+        DetectorLane& lane = *detector_lanes[sequence % detector_lanes.size()];
+        if (!lane_signal.wait([&lane]() { return lane.state.load(std::memory_order_acquire) == LaneState::free; }, stop)) {
+            break;
+        }
+
+        bool read;
+        {
+            PROFILE_ZONE("capture");
+            read = frame_source->read(lane.image); // the lane's buffer is reused, as far as the source allows
+        }
+        if (!read) {
             std::cerr << "Cam disconnected? End of video?" << std::endl;
             ended_tracker_thread = true;
+            tracker_stop.request_stop();
             break;
         }
 
-        faces = face_recognizer.find_face(cv_frame);
-        red = red_recognizer.find_red(cv_frame);
+        lane.state.store(LaneState::detecting, std::memory_order_relaxed);
+        sequence++;
+        TaskScheduler::global().submit_detached(&GLApp::run_detect_task, &lane);
+    }
+}
+
+void GLApp::run_detect_task(void* lane) {
+    auto detector_lane = static_cast<DetectorLane*>(lane);
+    detector_lane->app->detect_frame(*detector_lane);
+}
 
-        for (auto face : faces) {
-            draw_cross_normalized(cv_frame, face, 30, CV_RGB(0, 255, 0));
+void GLApp::detect_frame(DetectorLane& lane) {
+    // Stage 2: recognize and annotate, runs as a scheduler task, several frames at once
+    // On failure the frame is still passed on, the upload stage waits for every lane in turn
+    PROFILE_ZONE("detect");
+    lane.detection_frame.reset(lane.image); // pyramid and color conversions shared by both recognizers
+    lane.faces.clear();
+    lane.red = cv::Point2f{};
+
+    // face and red in parallel, they only read the image
+    TaskScheduler::global().parallel_for(0, 2, 1, [&lane](std::size_t task, std::size_t) {
+        try {
+            if (task == 0) {
+                PROFILE_ZONE("face");
+                lane.face_recognizer.find_face(lane.detection_frame, lane.face_workspace, lane.faces);
+            }
+            else {
+                PROFILE_ZONE("red");
+                lane.red = lane.red_recognizer.find_red(lane.detection_frame);
+            }
         }
-        draw_cross_normalized(cv_frame, red, 30);
+        catch (std::exception& e) {
+            std::cerr << (task == 0 ? "Face" : "Red") << " detection failed: " << e.what() << std::endl;
+        }
+    });
+
+    {
+        PROFILE_ZONE("annotate");
+        for (auto face : lane.faces) {
+            draw_cross_normalized(lane.image, face, 30, CV_RGB(0, 255, 0));
+        }
+        draw_cross_normalized(lane.image, lane.red, 30);
+    }
+
+    lane.state.store(LaneState::detected, std::memory_order_release);
+    lane_signal.notify_all(); // capture and upload wait on the same signal
+}
 
-        frame = frame_pool.acquire();
-        frame->fence_wait();
-        frame->replace_image(cv_frame);
-        frame->fence_sync();
+void GLApp::upload_worker(std::stop_token stop) {
+    // Stage 3: take the lanes back in capture order and upload them on the shared context
+    std::uint64_t sequence = 0;
 
-        de_queue.push_back(RecognizedData{
+    glfwMakeContextCurrent(tracker_worker_window);
+    PROFILE_THREAD("tracker upload");
+    GpuTimer upload_gpu_timer; // on this context
+    PixelUploadRing upload_ring(camera_width, camera_height, CV_8UC3); // frames are copied into mapped memory, the GPU pulls them from there
+
+    while (!stop.stop_requested()) {
+        DetectorLane& lane = *detector_lanes[sequence % detector_lanes.size()];
+        if (!lane_signal.wait([&lane]() { return lane.state.load(std::memory_order_acquire) == LaneState::detected; }, stop)) {
+            break;
+        }
+
+        auto frame = frame_pool.acquire(stop);
+        if (!frame) {
+            return; // stopped while waiting for a free frame
+        }
+        {
+            PROFILE_ZONE("upload");
+            frame->fence_wait();
+            upload_gpu_timer.begin();
+            frame->replace_image(lane.image, upload_ring);
+            upload_gpu_timer.end();
+            frame->fence_sync();
+        }
+        auto upload_ms = upload_gpu_timer.poll_ms();
+
+        publish_recognized_data(RecognizedData{
             std::move(frame),
-            faces,
-            red
+            lane.faces,
+            lane.red,
+            upload_ms ? static_cast<float>(*upload_ms) : -1.0f
         });
 
+        lane.state.store(LaneState::free, std::memory_order_release);
+        lane_signal.notify_all();
+        sequence++;
+
         if (FPS_tracker.is_updated())
             std::cout << "FPS tracker: " << FPS_tracker.get() << std::endl;
         FPS_tracker.update();
     }
 }
 
+void GLApp::publish_recognized_data(RecognizedData&& recognized_data) {
+    // Tracker thread side of the channel
+    switch (tracker_channel) {
+    case TrackerChannel::queue:
+        if (!de_queue.push_back(std::move(recognized_data))) {
+            // render loop is too far behind, the frame is dropped (its lease returns it to the pool)
+            queue_dropped_frames++;
+        }
+        break;
+    case TrackerChannel::mailbox:
+        // a displaced frame was never shown, dropping it returns it to the pool
+        mailbox.push_back(std::move(recognized_data));
+        break;
+    }
+}
+
+std::optional<GLApp::RecognizedData> GLApp::take_recognized_data() {
+    // Render loop side of the channel
+    switch (tracker_channel) {
+    case TrackerChannel::queue:
+        return de_queue.try_pop_front();
+    case TrackerChannel::mailbox:
+        return mailbox.try_pop_front();
+    }
+    return std::nullopt;
+}
+
+std::size_t GLApp::dropped_faces() {
+    std::size_t n_dropped = 0;
+    for (const auto& lane : detector_lanes) {
+        n_dropped += lane->face_recognizer.dropped_faces();
+    }
+    return n_dropped;
+}
+
+std::size_t GLApp::dropped_frames() {
+    return tracker_channel == TrackerChannel::mailbox ? mailbox.dropped() : queue_dropped_frames.load();
+}
+#pragma endregion
+
 #pragma region Callbacks
 // Callbacks
 void GLApp::glfw_error_callback(int error, const char* description) {
@@ -492,6 +746,13 @@ void GLApp::glfw_key_callback(GLFWwindow* window, int key, int scancode, int act
             }
             break;
         }
+        case GLFW_KEY_F12: // Profiler trace
+            if (!Profiler::enabled()) {
+                std::cout << "Profiling is not built in, configure with -DICP_PROFILING=ON" << std::endl;
+                break;
+            }
+            Profiler::write_chrome_trace("trace.json");
+            break;
         default:
                 this_inst->active_scene->on_key(key, action);
             break;
@@ -531,6 +792,30 @@ void GLApp::show_crosshair() {
     draw_list->AddLine(ImVec2(centerX - size, centerY), ImVec2(centerX + size, centerY), IM_COL32(255, 255, 255, 255), 2.0f); // horizontal
     draw_list->AddLine(ImVec2(centerX, centerY - size), ImVec2(centerX, centerY + size), IM_COL32(255, 255, 255, 255), 2.0f); // vertical
 }
+
+void GLApp::show_frame_times() {
+    // Rolling graphs of the last frames, GPU values come a few frames late (the queries are never waited for)
+    ImGui::SetNextWindowPos(ImVec2(window_width - 300 - 10, 300));
+    ImGui::SetNextWindowSize(ImVec2(300, 270));
+    ImGui::Begin("Frame times", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
+
+    auto show = [](const char* label, const FrameTimeHistory& history) {
+        ImGui::Text("%s p50 %.2f  p95 %.2f  p99 %.2f ms", label, history.percentile(0.5f), history.percentile(0.95f), history.percentile(0.99f));
+        ImGui::PushID(label);
+        ImGui::PlotLines("##history", history.values(), history.size(), history.offset(), nullptr, 0.0f, 33.3f, ImVec2(280, 30));
+        ImGui::PopID();
+    };
+    show("CPU frame ", cpu_frame_times);
+    show("GPU scene ", scene_gpu_times);
+    show("GPU ImGui ", imgui_gpu_times);
+    show("GPU upload", upload_gpu_times);
+
+    // The slower side limits the frame rate (with VSync on, both may be below the refresh interval)
+    float cpu_ms = cpu_frame_times.percentile(0.5f);
+    float gpu_ms = scene_gpu_times.percentile(0.5f) + imgui_gpu_times.percentile(0.5f);
+    ImGui::Text("Median frame is %s-bound", cpu_ms >= gpu_ms ? "CPU" : "GPU");
+    ImGui::End();
+}
 #pragma endregion
 
 GLApp::~GLApp() {
@@ -539,7 +824,7 @@ GLApp::~GLApp() {
     ended_tracker_thread = true;
 
     // Join threads
-    if (tracker_thread.joinable()) tracker_thread.join();
+    stop_tracker();
 
     // clean up ImGUI
     ImGui_ImplOpenGL3_Shutdown();
@@ -549,6 +834,10 @@ GLApp::~GLApp() {
     // clean up OpenCV
     cv::destroyAllWindows();
 
+    // GL objects of the main context
+    scene_gpu_timer.reset();
+    imgui_gpu_timer.reset();
+
     // clean-up GLFW
     if (window) {
         glfwDestroyWindow(window);
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "runners/HandoffBenchApp.hpp"
+#include "concurrency/SyncedDeque.hpp"
+#include "concurrency/SpscRing.hpp"
+
+namespace {
+    // Move-only payload shaped like GLApp::RecognizedData
+    typedef struct Sample {
+        std::chrono::steady_clock::time_point stamp;
+        std::unique_ptr<int> frame;
+        bool last = false;
+    } Sample;
+
+    // Small adapters so both queues are driven the same way
+    bool push(SyncedDeque<Sample>& queue, Sample&& sample) {
+        queue.push_back(std::move(sample));
+        return true;
+    }
+
+    template<std::size_t N>
+    bool push(SpscRing<Sample, N>& queue, Sample&& sample) {
+        return queue.push_back(std::move(sample));
+    }
+
+    double percentile(std::vector<double> values, double p) {
+        if (values.empty())
+            return 0.0;
+        std::sort(values.begin(), values.end());
+        auto index = static_cast<std::size_t>(p * (values.size() - 1) + 0.5);
+        return values[std::min(index, values.size() - 1)];
+    }
+}
+
+HandoffBenchApp::HandoffBenchApp() {
+    // Constructor
+}
+
+bool HandoffBenchApp::init() {
+    std::cout << "Handoff benchmark: " << case_duration.count() << " s per case\n";
+    return true;
+}
+
+int HandoffBenchApp::run() {
+    for (auto polling : { false, true }) {
+        for (auto rate : rates_hz) {
+            print_result(run_case<SyncedDeque<Sample>>("SyncedDeque", rate, polling));
+            print_result(run_case<SpscRing<Sample, 8>>("SpscRing", rate, polling));
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+template<typename Queue>
+HandoffBenchApp::BenchResult HandoffBenchApp::run_case(const std::string& queue_name, double rate_hz, bool polling) {
+    Queue queue;
+    BenchResult result{ queue_name, rate_hz, polling, {}, {} };
+    auto expected = static_cast<std::size_t>(case_duration.count() * rate_hz) + 1;
+    result.push_us.reserve(expected);
+    result.latency_us.reserve(expected);
+
+    std::jthread consumer([&queue, &result, polling]() {
+        while (true) {
+            if (!polling)
+                queue.wait();
+            auto sample = queue.try_pop_front();
+            if (!sample)
+                continue;
+            auto now = std::chrono::steady_clock::now();
+            if (sample->last)
+                break;
+            result.latency_us.push_back(std::chrono::duration<double, std::micro>(now - sample->stamp).count());
+        }
+    });
+
+    // Producer: paced at the requested rate
+    auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate_hz));
+    auto end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(case_duration);
+    auto next = std::chrono::steady_clock::now();
+    while (next < end) {
+        std::this_thread::sleep_until(next);
+        next += period;
+
+        auto start = std::chrono::steady_clock::now();
+        push(queue, Sample{ start, std::make_unique<int>(0) });
+        auto pushed = std::chrono::steady_clock::now();
+        result.push_us.push_back(std::chrono::duration<double, std::micro>(pushed - start).count());
+    }
+    while (!push(queue, Sample{ std::chrono::steady_clock::now(), nullptr, true }))
+        std::this_thread::yield();
+
+    consumer.join();
+    return result;
+}
+
+void HandoffBenchApp::print_result(const BenchResult& result) {
+    std::cout << std::fixed << std::setprecision(2)
+        << std::setw(12) << result.queue_name << " @ " << std::setw(6) << result.rate_hz << " Hz"
+        << (result.polling ? " polling " : " blocking")
+        << " | handoff p50 " << percentile(result.latency_us, 0.50) << " us"
+        << ", p99 " << percentile(result.latency_us, 0.99) << " us"
+        << ", max " << percentile(result.latency_us, 1.0) << " us"
+        << " | push p99 " << percentile(result.push_us, 0.99) << " us"
+        << " (" << result.latency_us.size() << " samples)\n";
+}
+
+HandoffBenchApp::~HandoffBenchApp() {
+}
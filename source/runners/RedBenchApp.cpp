@@ -0,0 +1,94 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+
+#include "runners/RedBenchApp.hpp"
+#include "recognizers/RedRecognizer.hpp"
+#include "recognizers/DetectionFrame.hpp"
+
+namespace {
+    cv::Mat all_colors_image() {
+        // Every 8-bit BGR color exactly once, 4096 x 4096
+        cv::Mat colors(4096, 4096, CV_8UC3);
+        for (int y = 0; y < colors.rows; y++) {
+            auto* row = colors.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < colors.cols; x++) {
+                int color = y * colors.cols + x;
+                row[x] = cv::Vec3b(color & 0xFF, (color >> 8) & 0xFF, (color >> 16) & 0xFF);
+            }
+        }
+        return colors;
+    }
+
+    double median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+}
+
+RedBenchApp::RedBenchApp() {
+    // Constructor
+}
+
+bool RedBenchApp::init() {
+    image = cv::imread(image_path);
+    if (image.empty()) {
+        std::cerr << "Error: Could not load " << image_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int RedBenchApp::run() {
+    bool passed = true;
+
+    passed &= check_case(image_path, image);
+    // odd sized view into the image: row padding and a scalar tail on every row
+    passed &= check_case("cropped view", image(cv::Rect(3, 5, image.cols - 10, image.rows - 7)));
+    passed &= check_case("all colors", all_colors_image());
+
+    time_case(image_path, image);
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool RedBenchApp::check_case(const std::string& name, const cv::Mat& frame) {
+    RedRecognizer red_recognizer;
+    DetectionFrame detection_frame(frame);
+
+    cv::Point2f expected = RedRecognizer::find_red_reference(frame);
+    cv::Point2f fused = red_recognizer.find_red(detection_frame);
+
+    // Same pixels classified means bit-identical sums, so no tolerance
+    bool same = expected == fused;
+    std::cout << std::setprecision(7) << name << ": reference " << expected << ", fused " << fused
+        << (same ? " OK" : " MISMATCH") << "\n";
+    return same;
+}
+
+void RedBenchApp::time_case(const std::string& name, const cv::Mat& frame) {
+    RedRecognizer red_recognizer;
+    std::vector<double> reference_ms, fused_ms;
+
+    for (int i = 0; i < n_repeats; i++) {
+        auto start = std::chrono::steady_clock::now();
+        RedRecognizer::find_red_reference(frame);
+        auto middle = std::chrono::steady_clock::now();
+        DetectionFrame detection_frame(frame);
+        red_recognizer.find_red(detection_frame);
+        auto end = std::chrono::steady_clock::now();
+
+        reference_ms.push_back(std::chrono::duration<double, std::milli>(middle - start).count());
+        fused_ms.push_back(std::chrono::duration<double, std::milli>(end - middle).count());
+    }
+
+    std::cout << std::setprecision(3) << name << " (" << frame.cols << "x" << frame.rows << "), median of " << n_repeats
+        << ": reference " << median(reference_ms) << " ms, fused " << median(fused_ms) << " ms\n";
+}
+
+RedBenchApp::~RedBenchApp()
+{
+}
@@ -0,0 +1,215 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+
+#include <opencv2/opencv.hpp>
+#include <nlohmann/json.hpp>
+
+#include "runners/TextureBakeApp.hpp"
+#include "render/Texture.hpp"
+
+TextureBakeApp::TextureBakeApp() {
+    // Constructor
+}
+
+bool TextureBakeApp::load_config(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open config file: " << filename << std::endl;
+        return false;
+    }
+
+    try {
+        nlohmann::json j;
+        file >> j;
+
+        if (j.contains("texturebake")) {
+            directory = j["texturebake"].value("directory", directory.string());
+            format = j["texturebake"].value("format", format);
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Error parsing JSON: " << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TextureBakeApp::init() {
+    if (!load_config("resources/config.json")) {
+        std::cerr << "Using default bake settings.\n";
+    }
+    if (format != "bc7" && format != "etc2") {
+        std::cerr << "Unknown texture cache format: " << format << " (bc7 or etc2)\n";
+        return false;
+    }
+
+    if (!glfwInit()) {
+        std::cerr << "Error: Could not initialize GLFW.\n";
+        return false;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window = glfwCreateWindow(1, 1, "", NULL, NULL);
+    if (!window) {
+        std::cerr << "Error: Could not create GLFW window. \n";
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "Error: Could not initialize GLEW.\n";
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<CompressedImage> TextureBakeApp::bake(const std::filesystem::path& source) {
+    cv::Mat image;
+    try {
+        image = Texture::load_image(source);
+    }
+    catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return std::nullopt;
+    }
+    if (image.depth() != CV_8U) {
+        std::cerr << "Only 8-bit images are baked: " << source << std::endl;
+        return std::nullopt;
+    }
+
+    bool has_alpha = image.channels() == 4;
+    cv::Mat bgra;
+    switch (image.channels()) {
+    case 1:
+        cv::cvtColor(image, bgra, cv::COLOR_GRAY2BGRA);
+        break;
+    case 3:
+        cv::cvtColor(image, bgra, cv::COLOR_BGR2BGRA);
+        break;
+    default:
+        bgra = image.clone();
+        break;
+    }
+    cv::flip(bgra, bgra, 0); // the same way up as Texture uploads images (Origin::bottom_left)
+
+    CompressedImage baked{};
+    baked.internal_format = format == "bc7" ? GL_COMPRESSED_RGBA_BPTC_UNORM : (has_alpha ? GL_COMPRESSED_RGBA8_ETC2_EAC : GL_COMPRESSED_RGB8_ETC2);
+    baked.width = bgra.cols;
+    baked.height = bgra.rows;
+    int n_levels = 1 + static_cast<int>(std::floor(std::log2(std::max(bgra.cols, bgra.rows))));
+
+    // A mutable texture with a compressed internal format: the driver encodes what is uploaded into it
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    bool ok = true;
+    cv::Mat level_image = bgra;
+    for (int level = 0; level < n_levels && ok; level++) {
+        int level_width = std::max(bgra.cols >> level, 1);
+        int level_height = std::max(bgra.rows >> level, 1);
+        if (level > 0) {
+            cv::resize(level_image, level_image, cv::Size(level_width, level_height), 0, 0, cv::INTER_AREA); // box filter, like glGenerateMipmap
+        }
+        glTexImage2D(GL_TEXTURE_2D, level, baked.internal_format, level_width, level_height, 0, GL_BGRA, GL_UNSIGNED_BYTE, level_image.data);
+
+        GLint compressed = GL_FALSE, internal_format = 0, size = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &compressed);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+        if (!compressed || static_cast<GLenum>(internal_format) != baked.internal_format
+            || static_cast<std::size_t>(size) != Ktx2::level_bytes(baked.internal_format, level_width, level_height)) {
+            std::cerr << "The driver did not encode " << format << " for " << source << " (level " << level << ")" << std::endl;
+            ok = false;
+            break;
+        }
+        std::vector<std::uint8_t> blocks(size);
+        glGetCompressedTexImage(GL_TEXTURE_2D, level, blocks.data());
+        baked.levels.push_back(std::move(blocks));
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDeleteTextures(1, &texture);
+    if (!ok) {
+        return std::nullopt;
+    }
+    return baked;
+}
+
+int TextureBakeApp::run() {
+    std::vector<std::filesystem::path> sources;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg")) {
+            sources.push_back(entry.path());
+        }
+    }
+    if (error || sources.empty()) {
+        std::cerr << "No images to bake in " << directory << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::sort(sources.begin(), sources.end());
+
+    // Bake
+    bool all_baked = true;
+    for (const auto& source : sources) {
+        auto baked = bake(source);
+        if (!baked || !Ktx2::write(Ktx2::cache_path(source), *baked)) {
+            all_baked = false;
+            continue;
+        }
+        std::cout << "Baked " << source << " -> " << Ktx2::cache_path(source) << " (" << baked->levels.size() << " levels)" << std::endl;
+    }
+
+    // Compare both load paths, each texture from the file to a finished upload
+    auto time_ms = [](auto load) {
+        auto start = std::chrono::steady_clock::now();
+        auto texture = load();
+        glFinish();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return std::make_pair(ms, texture->get_memory_bytes());
+    };
+
+    double decode_ms_total = 0.0, cache_ms_total = 0.0;
+    std::size_t decode_bytes_total = 0, cache_bytes_total = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\ntexture                            decode ms  cache ms   decode KiB  cache KiB\n";
+    for (const auto& source : sources) {
+        if (!Ktx2::is_cache_fresh(source)) {
+            continue;
+        }
+        auto [decode_ms, decode_bytes] = time_ms([&source]() { return std::make_shared<Texture>(Texture::load_image(source)); });
+        auto [cache_ms, cache_bytes] = time_ms([&source]() { return Texture::load(source); });
+        decode_ms_total += decode_ms;
+        cache_ms_total += cache_ms;
+        decode_bytes_total += decode_bytes;
+        cache_bytes_total += cache_bytes;
+        std::cout << std::left << std::setw(34) << source.filename().string() << std::right
+            << std::setw(10) << decode_ms << std::setw(10) << cache_ms
+            << std::setw(13) << decode_bytes / 1024.0 << std::setw(11) << cache_bytes / 1024.0 << "\n";
+    }
+    std::cout << std::left << std::setw(34) << "total" << std::right
+        << std::setw(10) << decode_ms_total << std::setw(10) << cache_ms_total
+        << std::setw(13) << decode_bytes_total / 1024.0 << std::setw(11) << cache_bytes_total / 1024.0 << std::endl;
+
+    return all_baked ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+TextureBakeApp::~TextureBakeApp() {
+    if (window) {
+        glfwDestroyWindow(window);
+        window = nullptr;
+    }
+    glfwTerminate();
+}
@@ -14,8 +14,8 @@ bool ThreadTrackApp::init() {
     static_image = cv::imread("resources/lock.png");
     warning_image = cv::imread("resources/warning.jpg");
 
-    if (!capture_device.open(0)) {
-        std::cerr << "Error: Could not open camera.\n";
+    frame_source = FrameSource::create(FrameSource::read_config("resources/config.json"));
+    if (!frame_source) {
         return false;
     }
 
@@ -41,8 +41,6 @@ bool ThreadTrackApp::init() {
 }
 
 int ThreadTrackApp::run() {
-    cv::Mat frame;
-
     ended_main = false;
 
     std::jthread tracker(&ThreadTrackApp::tracker_worker, this);
@@ -51,9 +49,8 @@ int ThreadTrackApp::run() {
     do {
         if (ended_tracker_thread || ended_gl) break;
 
-        if (!de_queue.empty()) {
-            de_queue.pop_front().copyTo(frame);
-            cv::imshow("Scene", frame);
+        if (auto frame = de_queue.try_pop_front()) {
+            cv::imshow("Scene", *frame);
         }
 
         // Measure and display fps
@@ -72,8 +69,7 @@ void ThreadTrackApp::tracker_worker() {
     cv::Mat frame;
 
     while(!ended_main){
-        capture_device.read(frame);
-        if (frame.empty()) {
+        if (!frame_source->read(frame)) {
             std::cerr << "Cam disconnected? End of video?" << std::endl;
             ended_tracker_thread = true;
             return;
@@ -87,24 +83,26 @@ void ThreadTrackApp::tracker_worker() {
             // 1. No face -> static image
         case 0:
             static_image.copyTo(frame);            
-            de_queue.push_back(std::move(frame));
             break;
 
             // 2. One face -> track "some" object (track red)
         case 1:
             draw_cross_normalized(frame, centers.front(), 30, CV_RGB(0, 255, 0));
             draw_cross_normalized(frame, red_recognizer.find_red(frame), 30);
-            de_queue.push_back(std::move(frame));
             break;
 
             // 3. More than one face -> display warning
         default:
             warning_image.copyTo(frame);
-            de_queue.push_back(std::move(frame));
+        }
+
+        if (!de_queue.push_back(std::move(frame))) {
+            // the display loop is too far behind, the frame is dropped
+            dropped_frames++;
         }
 
         if (FPS_tracker.is_updated())
-            std::cout << "FPS tracker: " << FPS_tracker.get() << std::endl;
+            std::cout << "FPS tracker: " << FPS_tracker.get() << ", dropped frames: " << dropped_frames << std::endl;
         FPS_tracker.update();
     }
 }
@@ -11,8 +11,8 @@ bool TrackApp::init() {
     static_image = cv::imread("resources/lock.png");
     warning_image = cv::imread("resources/warning.jpg");
 
-    if (!capture_device.open(0)) {
-        std::cerr << "Error: Could not open camera.\n";
+    frame_source = FrameSource::create(FrameSource::read_config("resources/config.json"));
+    if (!frame_source) {
         return false;
     }
     return true;
@@ -22,8 +22,7 @@ int TrackApp::run() {
     cv::Mat frame;
 
     do {
-        capture_device.read(frame);
-        if (frame.empty()) {
+        if (!frame_source->read(frame)) {
             std::cerr << "Cam disconnected? End of video?" << std::endl;
             return -1;
         }
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+
+#include <nlohmann/json.hpp>
+
+#include "runners/TrackBenchApp.hpp"
+#include "render/Drawings.hpp"
+
+TrackBenchApp::TrackBenchApp() {
+    // Constructor
+}
+
+bool TrackBenchApp::load_config(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open config file: " << filename << std::endl;
+        return false;
+    }
+
+    try {
+        nlohmann::json j;
+        file >> j;
+
+        if (j.contains("tracker")) {
+            face_tracking_on = j["tracker"].value("face_tracking", face_tracking_on);
+            face_full_scan_interval = j["tracker"].value("face_full_scan_interval", face_full_scan_interval);
+            face_scale = j["tracker"].value("face_scale", face_scale);
+            red_scale = j["tracker"].value("red_scale", red_scale);
+        }
+        // The bench has its own source (a recorded clip or synthetic frames), the app's one is usually the camera
+        if (j.contains("trackbench")) {
+            auto& bench = j["trackbench"];
+            n_frames = bench.value("frames", n_frames);
+            n_warmup_frames = bench.value("warmup_frames", n_warmup_frames);
+            output_path = bench.value("output", output_path);
+            jpeg_quality = bench.value("jpeg_quality", jpeg_quality);
+            if (bench.contains("source")) {
+                source_config = FrameSource::config_from_json(bench["source"]);
+            }
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Error parsing JSON: " << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TrackBenchApp::init() {
+    source_config.type = "synthetic";
+    if (!load_config("resources/config.json")) {
+        std::cerr << "Using default benchmark settings.\n";
+    }
+    source_config.max_speed = true; // throughput, not real time
+    source_config.loop = true;      // a short clip still gives n_frames
+
+    frame_source = FrameSource::create(source_config);
+    if (!frame_source) {
+        return false;
+    }
+    if (!face_recognizer.init()) {
+        return false;
+    }
+    face_recognizer.set_tracking(face_tracking_on, face_full_scan_interval);
+    face_recognizer.set_working_scale(face_scale);
+    red_recognizer.set_working_scale(red_scale);
+
+    cv::setNumThreads(1); // like GLApp, parallelism comes from the task scheduler
+
+    for (auto name : { "capture", "pyramid", "face", "red", "annotate", "encode", "total" }) {
+        stages.push_back(Stage{ name, {} });
+        stages.back().latency.reserve(n_frames);
+    }
+    return true;
+}
+
+int TrackBenchApp::run() {
+    // Buffers kept from frame to frame, like in a detector lane
+    cv::Mat image;
+    DetectionFrame detection_frame;
+    FaceWorkspace face_workspace;
+    FaceCenters faces;
+    cv::Point2f red;
+    std::vector<uchar> encoded;
+    const std::vector<int> encode_params{ cv::IMWRITE_JPEG_QUALITY, jpeg_quality };
+    const int face_level = DetectionFrame::level_for(face_scale);
+    const int red_level = DetectionFrame::level_for(red_scale);
+
+    std::size_t n_faces = 0, n_red = 0, n_bytes = 0;
+    std::chrono::steady_clock::time_point measured_start;
+
+    for (int i = 0; i < n_warmup_frames + n_frames; i++) {
+        bool measured = i >= n_warmup_frames;
+        if (i == n_warmup_frames) {
+            measured_start = std::chrono::steady_clock::now();
+        }
+        std::chrono::steady_clock::time_point t[n_stages];
+
+        t[capture_stage] = std::chrono::steady_clock::now();
+        if (!frame_source->read(image)) {
+            std::cerr << "Frame source ended after " << frame_source->frames_read() << " frames\n";
+            break;
+        }
+        t[pyramid_stage] = std::chrono::steady_clock::now();
+        detection_frame.reset(image);
+        detection_frame.gray(face_level);
+        detection_frame.bgr(red_level);
+        t[face_stage] = std::chrono::steady_clock::now();
+        face_recognizer.find_face(detection_frame, face_workspace, faces);
+        t[red_stage] = std::chrono::steady_clock::now();
+        red = red_recognizer.find_red(detection_frame);
+        t[annotate_stage] = std::chrono::steady_clock::now();
+        for (auto center : faces) {
+            draw_cross_normalized(image, center, 30, CV_RGB(0, 255, 0));
+        }
+        draw_cross_normalized(image, red, 30);
+        t[encode_stage] = std::chrono::steady_clock::now();
+        cv::imencode(".jpg", image, encoded, encode_params);
+        t[total_stage] = std::chrono::steady_clock::now();
+
+        if (measured) {
+            for (int stage = capture_stage; stage < total_stage; stage++) {
+                stages[stage].latency.add(t[stage + 1] - t[stage]);
+            }
+            stages[total_stage].latency.add(t[total_stage] - t[capture_stage]);
+            n_faces += faces.size();
+            n_red += (red.x != 0.0f || red.y != 0.0f);
+            n_bytes += encoded.size();
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - measured_start;
+    std::size_t n_measured = stages[total_stage].latency.count();
+    if (n_measured == 0) {
+        std::cerr << "Error: No frames measured.\n";
+        return EXIT_FAILURE;
+    }
+
+    nlohmann::json report;
+    report["source"] = frame_source->describe();
+    report["frame_width"] = frame_source->size().width;
+    report["frame_height"] = frame_source->size().height;
+    report["frames"] = n_measured;
+    report["warmup_frames"] = n_warmup_frames;
+    report["face_scale"] = face_scale;
+    report["red_scale"] = red_scale;
+    report["face_tracking"] = face_tracking_on;
+    report["throughput_fps"] = n_measured / elapsed.count();
+    report["faces_per_frame"] = static_cast<double>(n_faces) / n_measured;
+    report["red_found_ratio"] = static_cast<double>(n_red) / n_measured;
+    report["encoded_bytes_per_frame"] = static_cast<double>(n_bytes) / n_measured;
+    for (const auto& stage : stages) {
+        report["stages_us"][stage.name] = {
+            { "mean", stage.latency.mean() },
+            { "p50", stage.latency.percentile(0.50) },
+            { "p95", stage.latency.percentile(0.95) },
+            { "p99", stage.latency.percentile(0.99) },
+            { "max", stage.latency.max() },
+        };
+    }
+
+    std::cout << report.dump(2) << std::endl;
+
+    std::ofstream output(output_path);
+    if (!output.is_open()) {
+        std::cerr << "Error: Could not write " << output_path << std::endl;
+        return EXIT_FAILURE;
+    }
+    output << report.dump(2) << std::endl;
+    return EXIT_SUCCESS;
+}
+
+TrackBenchApp::~TrackBenchApp()
+{
+}
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <future>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -11,6 +13,7 @@
 #include "render/Model.hpp"
 #include "utils/Camera.hpp"
 #include "utils/MeshGen.hpp"
+#include "concurrency/TaskScheduler.hpp"
 
 ShooterScene::ShooterScene(int window_width, int window_height) {
     width = window_width;
@@ -25,20 +28,48 @@ ShooterScene::ShooterScene(int window_width, int window_height) {
 void ShooterScene::init_assets() {
     // Load shaders
     shader_library.emplace("simple_shader", std::make_shared<ShaderProgram>(std::filesystem::path("resources/basic_sdr/basic.vert"), std::filesystem::path("resources/basic_sdr/basic.frag")));
-    shader_library.emplace("texture_shader", std::make_shared<ShaderProgram>(std::filesystem::path("resources/texture_sdr/tex.vert"), std::filesystem::path("resources/texture_sdr/tex.frag")));
-    shader_library.at("texture_shader")->set_uniform("tex0", 0);
 
     // Load meshes
     mesh_library.emplace("cube", generate_cube(cube_atlas_cross));
     mesh_library.emplace("cube_single", generate_cube(cube_atlas_single));
     mesh_library.emplace("sphere_highpoly", generate_sphere(8, 8));
 
-    // Load textures
-    texture_library.emplace("yellow_flowers", std::make_shared<Texture>("resources/textures/yellow_flowers.jpg"));
-    texture_library.emplace("wood_box", std::make_shared<Texture>("resources/textures/box_rgb888.png"));
-    texture_library.emplace("wood_box_logos", std::make_shared<Texture>("resources/textures/wood_texture_cube_logos.png"));
-    texture_library.emplace("globe", std::make_shared<Texture>("resources/textures/globe_texture.jpg"));
-    texture_library.emplace("asteroid", std::make_shared<Texture>("resources/textures/asteroid_diffused.png"));
+    // Load textures: read the baked cache or decode in parallel on the task scheduler, upload here (GL context thread)
+    const std::vector<std::pair<std::string, std::filesystem::path>> texture_files{
+        { "yellow_flowers", "resources/textures/yellow_flowers.jpg" },
+        { "wood_box", "resources/textures/box_rgb888.png" },
+        { "wood_box_logos", "resources/textures/wood_texture_cube_logos.png" },
+        { "globe", "resources/textures/globe_texture.jpg" },
+        { "asteroid", "resources/textures/asteroid_diffused.png" },
+    };
+    auto& scheduler = TaskScheduler::global();
+    std::vector<std::future<Texture::Image>> decoded_images;
+    for (const auto& [name, path] : texture_files) {
+        decoded_images.push_back(scheduler.submit([path]() { return Texture::load_image_cached(path); }));
+    }
+    for (std::size_t i = 0; i < texture_files.size(); i++) {
+        texture_library.emplace(texture_files[i].first, Texture::create(scheduler.wait(decoded_images[i])));
+    }
+
+    // All textures stay resident, draws select them by index: the texture shader depends on how they are kept
+    texture_residency = std::make_unique<TextureResidency>();
+    for (const auto& [name, texture] : texture_library) {
+        texture_residency->add(texture);
+    }
+    texture_residency->make_resident();
+    shader_library.emplace("texture_shader", std::make_shared<ShaderProgram>(std::filesystem::path("resources/texture_sdr/tex.vert"), texture_residency->fragment_shader_path()));
+    if (texture_residency->get_mode() == TextureResidency::Mode::array) {
+        shader_library.at("texture_shader")->set_uniform("textures", TEXTURE_ARRAY_UNIT);
+    }
+
+    // Instanced variants for drawing the targets, they read the model matrices from the batcher's buffer
+    shader_library.emplace("simple_shader_instanced", std::make_shared<ShaderProgram>(std::filesystem::path("resources/basic_sdr/basic_instanced.vert"), std::filesystem::path("resources/basic_sdr/basic.frag")));
+    shader_library.emplace("texture_shader_instanced", std::make_shared<ShaderProgram>(std::filesystem::path("resources/texture_sdr/tex_instanced.vert"), texture_residency->fragment_shader_path()));
+    if (texture_residency->get_mode() == TextureResidency::Mode::array) {
+        shader_library.at("texture_shader_instanced")->set_uniform("textures", TEXTURE_ARRAY_UNIT);
+    }
+    instance_batcher.set_instanced_shader(shader_library.at("simple_shader").get(), shader_library.at("simple_shader_instanced"));
+    instance_batcher.set_instanced_shader(shader_library.at("texture_shader").get(), shader_library.at("texture_shader_instanced"));
 
     // Load models
     Model teapot_flower_model = Model("resources/meshes/teapot_tri_vnt.obj", shader_library.at("texture_shader"), texture_library.at("yellow_flowers"));
@@ -62,8 +93,13 @@ void ShooterScene::init_assets() {
     models.emplace("globe_object", std::move(globe_model));
 
     // Create index vector
-    for (auto& [key, model] : models)
+    for (auto& [key, model] : models) {
         model_names.push_back(key);
+        model.use_residency(*texture_residency);
+        for (auto& mesh_pkg : model.meshes) {
+            mesh_pkg.mesh->move_to(geometry_buffer); // meshes that do not fit keep their own buffers
+        }
+    }
 
     // Load audio
     audio_manager.load("ping", "resources/sounds/ping.wav", 0.5f, 10000.0f, 1.0f);
@@ -130,17 +166,23 @@ void ShooterScene::update(float dt) {
 }
 
 void ShooterScene::render() {
+    camera_uniforms.update(camera.get_view_matrix(), projection_matrix, camera.position);
 
     // Update listener location and clear sounds
     audio_manager.set_listener_position(camera.position.x, camera.position.y, camera.position.z, camera.front.x, camera.front.y, camera.front.z);
     audio_manager.clean_finished_sounds();
 
-    for (auto& sm : spawned_models) {
+    texture_residency->bind(); // all target textures at once
+
+    // Targets sharing a mesh, shader and texture are drawn by one instanced call
+    instance_batcher.begin();
+    for (const auto& sm : spawned_models) {
         if (!sm.active) continue;
 
-        sm.model->set_position(sm.position); // update model's transform
-        sm.model->draw(camera.get_view_matrix(), projection_matrix);
+        instance_batcher.add(*sm.model, sm.model->get_model_matrix_at(sm.position));
     }
+    instance_batcher.draw(render_queue, projection_matrix * camera.get_view_matrix()); // culled against the view frustum
+    render_queue.flush();
 }
 
 void ShooterScene::display_controls() {
@@ -149,15 +191,27 @@ void ShooterScene::display_controls() {
     ImGui::Text("X - Reset camera");
     ImGui::Text("E - switch color");
     ImGui::Text("Q - ping next target");
+    ImGui::Text("I - spawn 100 more of each target");
+    ImGui::Text("K - frustum culling: GPU / CPU / off");
     ImGui::Text("Scroll - change bgm volume");
     ImGui::Text("Movement:");
     ImGui::Text("Left Click - Enter Movement Mode / Shoot");
     ImGui::Text("Right Click - Exit Movement Mode");
     ImGui::Text("WASD + Space + C - Movement");
     ImGui::Text("Left Shift - Speed Boost");
+    ImGui::Text("Targets: %zu in %zu draw calls", instance_batcher.get_instance_count(), instance_batcher.get_draw_count());
+    const char* culling_names[] = { "GPU", "CPU", "off" };
+    CullStats cull_stats = instance_batcher.get_cull_stats();
+    ImGui::Text("Culling %s: %zu visible, %zu culled", culling_names[static_cast<int>(instance_batcher.get_culling())], cull_stats.visible, cull_stats.culled);
 }
 
 #pragma region Targets
+void ShooterScene::spawn_more_models() {
+    for (const auto& name : model_names) {
+        spawn_models(100, name);
+    }
+}
+
 void ShooterScene::spawn_models(int count, const std::string& model_name) {
     // Spawn instances of targets
     Model& model = models.at(model_name);
@@ -282,13 +336,15 @@ void ShooterScene::next_color() {
 }
 
 void ShooterScene::update_shader_color() {
+    static constexpr UniformId color_id{ "uniformColor" };
     glm::vec4 shader_color;
     switch (selected_color) {
     case 0: shader_color = glm::vec4(1, 0, 0, 1); break;
     case 1: shader_color = glm::vec4(0, 1, 0, 1); break;
     case 2: shader_color = glm::vec4(0, 0, 1, 1); break;
     }
-    shader_library.at("simple_shader")->set_uniform("uniformColor", shader_color);
+    shader_library.at("simple_shader")->set_uniform(color_id, shader_color);
+    shader_library.at("simple_shader_instanced")->set_uniform(color_id, shader_color);
 }
 
 glm::vec3 ShooterScene::clamp_to_bounds(const glm::vec3& p, const AABB& b) {
@@ -315,6 +371,12 @@ void ShooterScene::on_key(int key, int action) {
     case GLFW_KEY_X:
         camera.reset(glm::vec3(0, 0, 10));
         break;
+    case GLFW_KEY_I:
+        spawn_more_models();
+        break;
+    case GLFW_KEY_K:
+        instance_batcher.set_culling(static_cast<InstanceBatcher::Culling>((static_cast<int>(instance_batcher.get_culling()) + 1) % 3));
+        break;
     case GLFW_KEY_Q:
         for(auto& sm : spawned_models) {
             if (sm.active) {
@@ -36,10 +36,10 @@ void ViewerScene::init_assets() {
     mesh_library.emplace("sphere_highpoly", generate_sphere(8, 8));
 
     // Load textures
-    texture_library.emplace("yellow_flowers", std::make_shared<Texture>("resources/textures/yellow_flowers.jpg"));
-    texture_library.emplace("wood_box", std::make_shared<Texture>("resources/textures/box_rgb888.png"));
-    texture_library.emplace("wood_box_logos", std::make_shared<Texture>("resources/textures/wood_texture_cube_logos.png"));
-    texture_library.emplace("globe", std::make_shared<Texture>("resources/textures/globe_texture.jpg"));
+    texture_library.emplace("yellow_flowers", Texture::load("resources/textures/yellow_flowers.jpg"));
+    texture_library.emplace("wood_box", Texture::load("resources/textures/box_rgb888.png"));
+    texture_library.emplace("wood_box_logos", Texture::load("resources/textures/wood_texture_cube_logos.png"));
+    texture_library.emplace("globe", Texture::load("resources/textures/globe_texture.jpg"));
 
     // Load models
     Model teapot_model = Model("resources/meshes/teapot_tri_vnt.obj", shader_library.at("simple_shader"));
@@ -101,13 +101,16 @@ void ViewerScene::update(float dt) {
 }
 
 void ViewerScene::render() {
+    camera_uniforms.update(camera.get_view_matrix(), projection_matrix, camera.position);
+
     // Update listener location and clear sounds
     audio_manager.set_listener_position(camera.position.x, camera.position.y, camera.position.z, camera.front.x, camera.front.y, camera.front.z);
     audio_manager.clean_finished_sounds();
 
     // Model selection
     Model& model = models[model_names[selected_model]];
-    model.draw(camera.get_view_matrix(), projection_matrix);
+    model.submit(render_queue);
+    render_queue.flush();
 }
 
 void ViewerScene::display_controls() {
@@ -0,0 +1,70 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "utils/AllocationCounter.hpp"
+
+#ifdef ICP_COUNT_ALLOCATIONS
+namespace {
+    std::atomic<std::size_t> n_allocations{ 0 };
+
+    void* counted_alloc(std::size_t size) {
+        n_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* p = std::malloc(size ? size : 1)) {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* counted_aligned_alloc(std::size_t size, std::align_val_t alignment) {
+        n_allocations.fetch_add(1, std::memory_order_relaxed);
+        auto align = static_cast<std::size_t>(alignment);
+        size = (size + align - 1) / align * align; // aligned_alloc wants a multiple of the alignment
+#ifdef _WIN32
+        if (void* p = _aligned_malloc(size ? size : align, align)) {
+#else
+        if (void* p = std::aligned_alloc(align, size ? size : align)) {
+#endif
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    void aligned_free(void* p) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return counted_aligned_alloc(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return counted_aligned_alloc(size, alignment); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { aligned_free(p); }
+
+bool AllocationCounter::enabled() {
+    return true;
+}
+
+std::size_t AllocationCounter::count() {
+    return n_allocations.load(std::memory_order_relaxed);
+}
+#else
+bool AllocationCounter::enabled() {
+    return false;
+}
+
+std::size_t AllocationCounter::count() {
+    return 0;
+}
+#endif
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "utils/Profiler.hpp"
+
+namespace {
+    const auto profiler_epoch = std::chrono::steady_clock::now();
+
+    // Buffers stay alive until exit, so a finished thread's zones still end up in the trace
+    std::mutex registry_mux;
+    std::vector<std::unique_ptr<Profiler::ThreadBuffer>> registry;
+
+    typedef struct CopiedEvent {
+        const char* name;
+        std::int64_t begin_ns, end_ns;
+    } CopiedEvent;
+
+    typedef struct ThreadSnapshot {
+        std::uint32_t thread_id;
+        const char* thread_name;
+        std::vector<CopiedEvent> events;
+    } ThreadSnapshot;
+
+    void write_escaped(std::ostream& out, const char* text) {
+        for (; *text; text++) {
+            if (*text == '"' || *text == '\\') {
+                out << '\\';
+            }
+            out << *text;
+        }
+    }
+}
+
+bool Profiler::enabled() {
+#ifdef ICP_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::int64_t Profiler::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profiler_epoch).count();
+}
+
+Profiler::ThreadBuffer& Profiler::thread_buffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        auto new_buffer = std::make_unique<ThreadBuffer>();
+        std::scoped_lock lock(registry_mux);
+        new_buffer->thread_id = static_cast<std::uint32_t>(registry.size() + 1);
+        buffer = new_buffer.get();
+        registry.push_back(std::move(new_buffer));
+    }
+    return *buffer;
+}
+
+void Profiler::set_thread_name(const char* name) {
+    thread_buffer().thread_name.store(name, std::memory_order_relaxed);
+}
+
+bool Profiler::write_chrome_trace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Could not write trace: " << path << std::endl;
+        return false;
+    }
+
+    // Copy every ring under the lock, write the file after it: new threads are not held up by the disk
+    std::vector<ThreadSnapshot> snapshots;
+    {
+        std::scoped_lock lock(registry_mux);
+        snapshots.reserve(registry.size());
+        for (const auto& buffer : registry) {
+            // The owner keeps recording: copy what is there, then drop whatever it may have overwritten meanwhile
+            ThreadSnapshot& snapshot = snapshots.emplace_back();
+            snapshot.thread_id = buffer->thread_id;
+            snapshot.thread_name = buffer->thread_name.load(std::memory_order_relaxed);
+            std::uint64_t end = buffer->n_events.load(std::memory_order_acquire);
+            std::uint64_t begin = end > PROFILER_EVENTS_PER_THREAD ? end - PROFILER_EVENTS_PER_THREAD : 0;
+            snapshot.events.reserve(static_cast<std::size_t>(end - begin));
+            for (std::uint64_t i = begin; i < end; i++) {
+                const Event& event = buffer->events[i % PROFILER_EVENTS_PER_THREAD];
+                snapshot.events.push_back(CopiedEvent{
+                    event.name.load(std::memory_order_acquire), // keeps the count below from being read any earlier
+                    event.begin_ns.load(std::memory_order_acquire),
+                    event.end_ns.load(std::memory_order_acquire)
+                });
+            }
+            std::uint64_t end_after = buffer->n_events.load(std::memory_order_relaxed);
+            std::size_t n_overwritten = static_cast<std::size_t>(std::min<std::uint64_t>(
+                end_after > PROFILER_EVENTS_PER_THREAD + begin ? end_after - PROFILER_EVENTS_PER_THREAD - begin : 0,
+                snapshot.events.size()));
+            snapshot.events.erase(snapshot.events.begin(), snapshot.events.begin() + n_overwritten);
+        }
+    }
+
+    bool first = true;
+    auto separator = [&out, &first]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto& snapshot : snapshots) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << snapshot.thread_id << ",\"args\":{\"name\":\"";
+        if (snapshot.thread_name) {
+            write_escaped(out, snapshot.thread_name);
+        }
+        else {
+            out << "thread " << snapshot.thread_id;
+        }
+        out << "\"}}";
+
+        out << std::fixed << std::setprecision(3);
+        for (const CopiedEvent& event : snapshot.events) {
+            if (!event.name) {
+                continue;
+            }
+            separator();
+            out << "{\"name\":\"";
+            write_escaped(out, event.name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << snapshot.thread_id
+                << ",\"ts\":" << event.begin_ns / 1000.0
+                << ",\"dur\":" << (event.end_ns - event.begin_ns) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    std::cout << "Trace written to: " << path << std::endl;
+    return true;
+}